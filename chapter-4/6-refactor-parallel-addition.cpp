@@ -1,46 +1,248 @@
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <thread>
 #include <random>
 #include <limits>
 #include <chrono>
+#include <new>
 #include <list>
 #include <future>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_X86_KERNELS
+#endif
+
+/* 64-byte aligned storage: one cache line, one AVX-512 register */
+template <typename T, std::size_t Align = 64>
+struct aligned_allocator
+{
+    using value_type = T;
+    static constexpr std::align_val_t alignment{Align};
+
+    aligned_allocator() = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) {}
+
+    template <typename U>
+    struct rebind { using other = aligned_allocator<U, Align>; };
+
+    T* allocate(std::size_t n) {
+	if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+	    throw std::bad_array_new_length{};
+	return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+	::operator delete(p, alignment);
+    }
+};
+
+template <typename T, typename U, std::size_t Align>
+bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) { return true; }
+
+/* Kernels behind operator+, dot and the copies, picked once at run time by
+   what the CPU supports. Stores of buffers larger than the last level cache
+   bypass it, the data would only evict everything else on its way out. */
+namespace kernels {
+
+constexpr std::size_t streaming_bytes = std::size_t{8} << 20;
+
+void add_scalar(double* sum, const double* a, const double* b, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+	sum[i] = a[i] + b[i];
+}
+
+double dot_scalar(const double* a, const double* b, std::size_t n)
+{
+    double s = 0;
+    for (std::size_t i = 0; i < n; ++i)
+	s += a[i] * b[i];
+    return s;
+}
+
+void copy_scalar(double* dst, const double* src, std::size_t n)
+{
+    std::memcpy(dst, src, n * sizeof(double));
+}
+
+#ifdef VECTOR_X86_KERNELS
+bool streams(const double* dst, std::size_t n, std::size_t align)
+{
+    return n * sizeof(double) >= streaming_bytes && reinterpret_cast<std::uintptr_t>(dst) % align == 0;
+}
+
+__attribute__((target("avx2,fma")))
+void add_avx2(double* sum, const double* a, const double* b, std::size_t n)
+{
+    std::size_t i = 0;
+    if (streams(sum, n, 32)) {
+	for (; i + 4 <= n; i += 4)
+	    _mm256_stream_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+	_mm_sfence();
+    } else {
+	for (; i + 4 <= n; i += 4)
+	    _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (; i < n; ++i)
+	sum[i] = a[i] + b[i];
+}
+
+// four accumulators hide the latency of the fma, the sum is reassociated
+// and may differ from the scalar one in the last bits
+__attribute__((target("avx2,fma")))
+double dot_avx2(const double* a, const double* b, std::size_t n)
+{
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+	s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i),      _mm256_loadu_pd(b + i),      s0);
+	s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4),  _mm256_loadu_pd(b + i + 4),  s1);
+	s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8),  _mm256_loadu_pd(b + i + 8),  s2);
+	s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+    }
+    for (; i + 4 <= n; i += 4)
+	s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+
+    const __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    double r = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; i < n; ++i)
+	r += a[i] * b[i];
+    return r;
+}
+
+__attribute__((target("avx2")))
+void copy_avx2(double* dst, const double* src, std::size_t n)
+{
+    if (!streams(dst, n, 32))
+	return copy_scalar(dst, src, n);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+	_mm256_stream_pd(dst + i, _mm256_loadu_pd(src + i));
+    _mm_sfence();
+    for (; i < n; ++i)
+	dst[i] = src[i];
+}
+
+// tails are handled with masked loads and stores
+__attribute__((target("avx512f")))
+void add_avx512(double* sum, const double* a, const double* b, std::size_t n)
+{
+    std::size_t i = 0;
+    if (streams(sum, n, 64)) {
+	for (; i + 8 <= n; i += 8)
+	    _mm512_stream_pd(sum + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+	_mm_sfence();
+    } else {
+	for (; i + 8 <= n; i += 8)
+	    _mm512_storeu_pd(sum + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(sum + i, tail, _mm512_add_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i)));
+}
+
+__attribute__((target("avx512f")))
+double dot_avx512(const double* a, const double* b, std::size_t n)
+{
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+	s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i),      _mm512_loadu_pd(b + i),      s0);
+	s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8),  _mm512_loadu_pd(b + i + 8),  s1);
+	s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
+	s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
+    }
+    for (; i + 8 <= n; i += 8)
+	s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+    const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(tail, a + i), _mm512_maskz_loadu_pd(tail, b + i), s1);
+
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+void copy_avx512(double* dst, const double* src, std::size_t n)
+{
+    if (!streams(dst, n, 64))
+	return copy_scalar(dst, src, n);
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+	_mm512_stream_pd(dst + i, _mm512_loadu_pd(src + i));
+    _mm_sfence();
+    const __mmask8 tail = static_cast<__mmask8>((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(dst + i, tail, _mm512_maskz_loadu_pd(tail, src + i));
+}
+#endif
+
+struct dispatch
+{
+    const char* name;
+    void   (*add)(double*, const double*, const double*, std::size_t);
+    double (*dot)(const double*, const double*, std::size_t);
+    void   (*copy)(double*, const double*, std::size_t);
+};
+
+const dispatch& select()
+{
+    static const dispatch d = [] {
+#ifdef VECTOR_X86_KERNELS
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	    return dispatch{"avx512", add_avx512, dot_avx512, copy_avx512};
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	    return dispatch{"avx2", add_avx2, dot_avx2, copy_avx2};
+#endif
+	return dispatch{"scalar", add_scalar, dot_scalar, copy_scalar};
+    }();
+    return d;
+}
+
+} // namespace kernels
+
 /* Taken as a reference from the book for this exercise */
 class vector 
 {
+    using allocator = aligned_allocator<double>;
+
   public:
-    vector(int size) : my_size(size), data(new double[size]) {}
+    vector(std::size_t size) : my_size(size), data(allocator{}.allocate(size)) {}
 
-    vector() : my_size(0), data(0) {}
+    vector() : my_size(0), data(nullptr) {}
 
-    ~vector() { delete[] data; }
+    ~vector() { if (data) allocator{}.deallocate(data, my_size); }
 
     vector(const vector& that) 
-      : my_size(that.my_size), data(new double[my_size])
+      : my_size(that.my_size), data(allocator{}.allocate(my_size))
     {
-	for (int i=0; i<my_size; ++i) { data[i] = that.data[i]; }
+	kernels::select().copy(data, that.data, my_size);
     }
 
     vector& operator=(const vector& that) 
     {
 	assert(that.my_size == my_size);
-	for (int i=0; i<my_size; ++i) 
-	    data[i] = that.data[i];
+	if (this != &that)
+	    kernels::select().copy(data, that.data, my_size);
     return *this;
     }
 
-    int size() const { return my_size; }
-    int size() { return my_size; }
+    std::size_t size() const { return my_size; }
 
-    double& operator[](int i) const {
-	assert(i>=0 && i<my_size);
+    double& operator[](std::size_t i) const {
+	assert(i<my_size);
 	return data[i];
     }
 
-    double& operator[](int i) {
-	assert(i>=0 && i<my_size);
+    double& operator[](std::size_t i) {
+	assert(i<my_size);
 	return data[i];
 
     }
@@ -48,30 +250,29 @@ class vector
     vector operator+(const vector& that) const {
 	assert(that.my_size == my_size);
 	vector sum(my_size);
-	for (int i= 0; i < my_size; ++i)
-	    sum[i] = (*this)[i] + that[i]; 
+	kernels::select().add(sum.data, data, that.data, my_size);
 	return sum;
     }
 
+    friend double dot(const vector& v, const vector& w);
+
   private:
-    int     my_size;
-    double* data;
+    std::size_t my_size;
+    double*     data;
 };
 
 std::ostream& operator<<(std::ostream& os, const vector& v)
 {
   os << '[';
-  for (int i= 0; i < v.size(); ++i) os << v[i] << ',';
+  for (std::size_t i= 0; i < v.size(); ++i) os << v[i] << ',';
   os << ']';
   return os;
 }
 
 double dot(const vector& v, const vector& w) 
 {
-    double s;
-    for (int i= 0; i < v.size(); i++)
-	s+= v[i] * w[i];
-    return s;
+    assert(v.my_size == w.my_size);
+    return kernels::select().dot(v.data, w.data, v.my_size);
 }
 
 /* simple randomization */
@@ -98,19 +299,20 @@ vector vector_sum(const vector& lhs, const vector& rhs) {
 }
 
 int main() {
+    std::cout << "Using " << kernels::select().name << " kernels" << std::endl;
     std::cout << std::thread::hardware_concurrency() << " threads available.\n";
 
     std::list<std::future<vector>> lf;
 
     vector sizes(std::thread::hardware_concurrency());
     sizes[0] = 5;
-    for (int i = 1; i < sizes.size(); i++) {
+    for (std::size_t i = 1; i < sizes.size(); i++) {
         sizes[i] = sizes[i-1]*5;
     }
 
     std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
 
-    for (int i = 0; i < sizes.size() - 1; i++) {
+    for (std::size_t i = 0; i + 1 < sizes.size(); i++) {
         vector v00(sizes[i]);
         vector v01(sizes[i]);
         vector res0(sizes[i]);
@@ -118,13 +320,13 @@ int main() {
         vector v11(sizes[i+1]);
         vector res1(sizes[i+1]);
 
-        for (int j = 0; j < sizes[i]; j++) {
+        for (std::size_t j = 0; j < sizes[i]; j++) {
             v00[j] = pick(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
             v01[j] = pick(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
             // v00[j] = pick(0, 10);
             // v01[j] = pick(0, 10);
         }
-        for (int j = 0; j < sizes[i+1]; j++) {
+        for (std::size_t j = 0; j < sizes[i+1]; j++) {
             v10[j] = pick(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
             v11[j] = pick(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
             // v10[j] = pick(0, 10);
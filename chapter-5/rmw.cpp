@@ -1,10 +1,43 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
 #include <concepts>
+#include <coroutine>
 #include <limits>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
 #include <tuple>
 #include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // Register Optimization with Safety (ROS)
 
@@ -148,22 +181,54 @@ enum class access_type : uint8_t {
     W = WO
 };
 
+// what apply tells a profiling bus about each register and field it touches
+enum class access_event : uint8_t {
+    read,
+    write,
+    rmw,
+    error
+};
+
 // file: error.hpp
 namespace error {
 
+    // what the error channel of a register gets to know about an error.
+    // address and mask identify the field, mask is the register layout for
+    // whole register assignments
+    struct record {
+        std::size_t address;
+        std::uint64_t mask;
+        std::uint64_t value;
+        std::uint64_t timestamp;
+    };
+
+    // hands the error over to the error policy of the register, see policy.hpp.
+    // Source is the field at fault, or the register itself
+    template <typename Register, typename Source = typename Register::reg_der>
+    void report(std::uint64_t mask, std::uint64_t value) {
+        using reg = typename Register::reg_der;
+        reg::error_policy::template report<reg>(mask, value);
+        if constexpr (reg::bus::profiled) {
+            reg::bus::template count<access_event::error, reg>();
+            if constexpr (not std::is_same_v<Source, reg>) {
+                reg::bus::template count<access_event::error, Source>();
+            }
+        }
+    }
+
     template <typename Field, typename T = typename Field::value_type>
     using field_error_handler = T(*)(T);
 
     template <typename Field, typename T = typename Field::value_type>
     constexpr field_error_handler<Field> ignore_handler = [](T v) -> T {
-        std::cout << "ignore handler with " << v << std::endl;
+        report<typename Field::reg, Field>(Field::mask, static_cast<std::uint64_t>(v));
         return T{0};
     };
     template <typename Field, typename T = typename Field::value_type>
     constexpr field_error_handler<Field> clamp_handler = [](T v) -> T {
         using value_type_r = typename Field::value_type_r;
-        std::cout << "clamp handler with " << static_cast<value_type_r>(v) << std::endl;
-        return T{((1 << Field::length) - 1)};
+        report<typename Field::reg, Field>(Field::mask, static_cast<std::uint64_t>(v));
+        return T{((value_type_r{1} << Field::length) - 1)};
     };
     template <typename Field>
     constexpr field_error_handler<Field> handle_field_error = clamp_handler<Field>;
@@ -173,7 +238,7 @@ namespace error {
 
     template <typename Register, typename T = typename Register::value_type>
     constexpr register_error_handler<Register> mask_handler = [](T v) -> T {
-        std::cout << "Attempt to assign read-only bits with " << v << std::endl;
+        report<Register>(Register::layout, static_cast<std::uint64_t>(v));
         return T{v & Register::layout};
     };
     template <typename Register>
@@ -181,8 +246,6 @@ namespace error {
 
 } // namespace ros::error
 
-// [TODO]: Add disjoint field support
-
 // file: field.hpp
 namespace detail {
 template <typename T>
@@ -338,15 +401,35 @@ struct universal_type {
     operator T() {}
 };
 
-template<typename T>
-consteval auto get_struct_size(auto ...members) {
-    if constexpr (requires { T{ members... }; } == false) {
-        return sizeof...(members) - 2; // self and unsafe members
+// fields to_tuple can unpack, see to_tuple_helper below
+inline constexpr std::size_t max_fields = 64;
+
+template<typename T, std::size_t ...Is>
+consteval bool initializable_with(std::index_sequence<Is...>) {
+    return requires { T{ (void(Is), universal_type{})... }; };
+}
+
+// T takes Lo initializers and not Hi. an aggregate taking n takes fewer too,
+// so the count is bisected: log2 probes instead of one per member
+template<typename T, std::size_t Lo, std::size_t Hi>
+consteval std::size_t count_initializers() {
+    if constexpr (Hi - Lo == 1) {
+        return Lo;
+    } else if constexpr (constexpr std::size_t mid = (Lo + Hi) / 2; initializable_with<T>(std::make_index_sequence<mid>{})) {
+        return count_initializers<T, mid, Hi>();
     } else {
-        return get_struct_size<T>(members..., universal_type{});
+        return count_initializers<T, Lo, mid>();
     }
 }
 
+template<typename T>
+consteval auto get_struct_size() {
+    // the ros::reg base takes the first initializer. one more to tell too many fields
+    constexpr std::size_t size = count_initializers<T, 0, max_fields + 1 + 2>() - 1;
+    static_assert(size <= max_fields, "reflect::to_tuple supports registers with up to 64 fields");
+    return size;
+}
+
 template <typename T>
 constexpr auto forward(T && t) {
     return std::forward<T>(t);
@@ -362,37 +445,83 @@ struct to_tuple_helper<T, 0> {
     }
 };
 
-template <typename T>
-struct to_tuple_helper<T, 1> {
-    constexpr auto operator() (T const& t) const {
-        auto&& [f0] = forward(t);
-        return std::make_tuple(f0);
-    }
-};
-
-template <typename T>
-struct to_tuple_helper<T, 2> {
-    constexpr auto operator() (T const& t) const {
-        auto&& [f0, f1] = forward(t);
-        return std::make_tuple(f0, f1);
-    }
-};
-
-template <typename T>
-struct to_tuple_helper<T, 3> {
-    constexpr auto operator() (T const& t) const {
-        auto&& [f0, f1, f2] = forward(t);
-        return std::make_tuple(f0, f1, f2);
-    }
+// structured bindings can't be variadic, so one specialization per member
+// count is stamped out. supports registers with up to 64 fields
+#define ROS_TO_TUPLE_HELPER(N, ...)                        \
+template <typename T>                                      \
+struct to_tuple_helper<T, N> {                             \
+    constexpr auto operator() (T const& t) const {         \
+        auto&& [__VA_ARGS__] = forward(t);                 \
+        return std::make_tuple(__VA_ARGS__);               \
+    }                                                      \
 };
 
-template <typename T>
-struct to_tuple_helper<T, 4> {
-    constexpr auto operator() (T const& t) const {
-        auto&& [f0, f1, f2, f3] = forward(t);
-        return std::make_tuple(f0, f1, f2, f3);
-    }
-};
+ROS_TO_TUPLE_HELPER(1, f0)
+ROS_TO_TUPLE_HELPER(2, f0, f1)
+ROS_TO_TUPLE_HELPER(3, f0, f1, f2)
+ROS_TO_TUPLE_HELPER(4, f0, f1, f2, f3)
+ROS_TO_TUPLE_HELPER(5, f0, f1, f2, f3, f4)
+ROS_TO_TUPLE_HELPER(6, f0, f1, f2, f3, f4, f5)
+ROS_TO_TUPLE_HELPER(7, f0, f1, f2, f3, f4, f5, f6)
+ROS_TO_TUPLE_HELPER(8, f0, f1, f2, f3, f4, f5, f6, f7)
+ROS_TO_TUPLE_HELPER(9, f0, f1, f2, f3, f4, f5, f6, f7, f8)
+ROS_TO_TUPLE_HELPER(10, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9)
+ROS_TO_TUPLE_HELPER(11, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10)
+ROS_TO_TUPLE_HELPER(12, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11)
+ROS_TO_TUPLE_HELPER(13, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12)
+ROS_TO_TUPLE_HELPER(14, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13)
+ROS_TO_TUPLE_HELPER(15, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14)
+ROS_TO_TUPLE_HELPER(16, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15)
+ROS_TO_TUPLE_HELPER(17, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16)
+ROS_TO_TUPLE_HELPER(18, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17)
+ROS_TO_TUPLE_HELPER(19, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18)
+ROS_TO_TUPLE_HELPER(20, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19)
+ROS_TO_TUPLE_HELPER(21, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20)
+ROS_TO_TUPLE_HELPER(22, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21)
+ROS_TO_TUPLE_HELPER(23, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22)
+ROS_TO_TUPLE_HELPER(24, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23)
+ROS_TO_TUPLE_HELPER(25, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24)
+ROS_TO_TUPLE_HELPER(26, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25)
+ROS_TO_TUPLE_HELPER(27, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26)
+ROS_TO_TUPLE_HELPER(28, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27)
+ROS_TO_TUPLE_HELPER(29, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28)
+ROS_TO_TUPLE_HELPER(30, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29)
+ROS_TO_TUPLE_HELPER(31, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30)
+ROS_TO_TUPLE_HELPER(32, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31)
+ROS_TO_TUPLE_HELPER(33, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32)
+ROS_TO_TUPLE_HELPER(34, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33)
+ROS_TO_TUPLE_HELPER(35, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34)
+ROS_TO_TUPLE_HELPER(36, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35)
+ROS_TO_TUPLE_HELPER(37, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36)
+ROS_TO_TUPLE_HELPER(38, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37)
+ROS_TO_TUPLE_HELPER(39, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38)
+ROS_TO_TUPLE_HELPER(40, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39)
+ROS_TO_TUPLE_HELPER(41, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40)
+ROS_TO_TUPLE_HELPER(42, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41)
+ROS_TO_TUPLE_HELPER(43, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42)
+ROS_TO_TUPLE_HELPER(44, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43)
+ROS_TO_TUPLE_HELPER(45, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44)
+ROS_TO_TUPLE_HELPER(46, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45)
+ROS_TO_TUPLE_HELPER(47, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46)
+ROS_TO_TUPLE_HELPER(48, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47)
+ROS_TO_TUPLE_HELPER(49, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48)
+ROS_TO_TUPLE_HELPER(50, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49)
+ROS_TO_TUPLE_HELPER(51, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50)
+ROS_TO_TUPLE_HELPER(52, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51)
+ROS_TO_TUPLE_HELPER(53, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52)
+ROS_TO_TUPLE_HELPER(54, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53)
+ROS_TO_TUPLE_HELPER(55, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54)
+ROS_TO_TUPLE_HELPER(56, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55)
+ROS_TO_TUPLE_HELPER(57, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56)
+ROS_TO_TUPLE_HELPER(58, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57)
+ROS_TO_TUPLE_HELPER(59, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58)
+ROS_TO_TUPLE_HELPER(60, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59)
+ROS_TO_TUPLE_HELPER(61, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60)
+ROS_TO_TUPLE_HELPER(62, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61)
+ROS_TO_TUPLE_HELPER(63, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62)
+ROS_TO_TUPLE_HELPER(64, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31, f32, f33, f34, f35, f36, f37, f38, f39, f40, f41, f42, f43, f44, f45, f46, f47, f48, f49, f50, f51, f52, f53, f54, f55, f56, f57, f58, f59, f60, f61, f62, f63)
+
+#undef ROS_TO_TUPLE_HELPER
 
 template <typename T>
 constexpr auto to_tuple(T const& t) {
@@ -465,51 +594,74 @@ constexpr bool check_ro_fields (reg const& r) {
     constexpr std::size_t tup_size = std::tuple_size_v<decltype(tup)>;
     return check_rw_fields_helper(ros::access_type::RO, tup, std::make_index_sequence<tup_size>{});
 }
-} // namespace ros::detail
 
-// file: field.hpp
-template <typename reg_derived, 
-          detail::msb msb, detail::lsb lsb, 
-          access_type at, 
-          detail::field_type value_type_f = typename reg_derived::value_type>
-requires detail::field_selectable<value_type_f, msb, lsb>
-struct field {
-    using value_type_r = typename reg_derived::value_type;
-    using value_type = value_type_f;
-    using reg = reg_derived;
+// fields with write side effects (clear/set on write)
+template <typename Tup, std::size_t ...Idx>
+constexpr bool check_side_effect_fields_helper (Tup const&, std::index_sequence<Idx...>) {
+    return (
+        (
+            std::tuple_element_t<Idx, Tup>::access == access_type::RW_0C ||
+            std::tuple_element_t<Idx, Tup>::access == access_type::RW_1C ||
+            std::tuple_element_t<Idx, Tup>::access == access_type::RW_1S
+        ) || ...
+    );
+};
 
-    static constexpr access_type access = at;
+template <typename reg>
+constexpr bool check_side_effect_fields (reg const& r) {
+    auto tup = reflect::to_tuple(r);
+    constexpr std::size_t tup_size = std::tuple_size_v<decltype(tup)>;
+    return check_side_effect_fields_helper(tup, std::make_index_sequence<tup_size>{});
+}
 
-    static constexpr uint8_t length = []() {
-        return msb.value == lsb.value ? 1 : msb.value - lsb.value;
-    }();
+template <typename T, typename Tup, std::size_t ...Idx>
+constexpr T get_access_mask_helper (access_type at, Tup const&, std::index_sequence<Idx...>) {
+    return (T{0} | ... | (std::tuple_element_t<Idx, Tup>::access == at ? std::tuple_element_t<Idx, Tup>::mask : T{0}));
+};
 
-    static constexpr value_type_r mask = []() {
-        if (msb.value != lsb.value) {
-            if (msb.value == std::numeric_limits<value_type_r>::digits-1) {
-                return ~((1u << lsb.value) - 1);
-            } else {
-                return ((1u << msb.value) - 1) & ~((1u << lsb.value) - 1);
-            }
+// bits of all fields with access type at
+template <typename reg>
+constexpr typename reg::value_type get_access_mask (reg const& r, access_type at) {
+    auto tup = reflect::to_tuple(r);
+    constexpr std::size_t tup_size = std::tuple_size_v<decltype(tup)>;
+    return get_access_mask_helper<typename reg::value_type>(at, tup, std::make_index_sequence<tup_size>{});
+}
+} // namespace ros::detail
+
+// file: field.hpp
+namespace detail {
+
+template <typename T>
+constexpr T field_mask(unsigned msb, unsigned lsb) {
+    if (msb != lsb) {
+        if (msb == std::numeric_limits<T>::digits-1) {
+            return static_cast<T>(~((T{1} << lsb) - 1));
         } else {
-            return 1u << msb.value;
+            return static_cast<T>(((T{1} << msb) - 1) & ~((T{1} << lsb) - 1));
         }
-    }();
-
-    constexpr field() = default;
+    } else {
+        return static_cast<T>(T{1} << msb);
+    }
+}
 
+// assignment, read and invocable operations shared by all kinds of fields.
+// Field provides access, value_type, value_type_r, length, max_value and
+// runtime_check
+template <typename Field>
+struct field_operations_handler {
     template <typename U, U val>
-    requires (std::is_convertible_v<U, value_type>)
-    constexpr auto operator= (detail::field_value<U, val>) const -> detail::field_assignment_ct<field, val> {
+    requires (std::is_convertible_v<U, typename Field::value_type>)
+    constexpr auto operator= (field_value<U, val>) const {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::W)) != 0, 
             "Cannot write non-writable field");
         static_assert(
-            val <= (mask >> lsb.value), 
+            val <= Field::max_value, 
             "Assigned value greater than the field length");
         
-        return ros::detail::field_assignment_ct<field, val>{};
+        return field_assignment_ct<Field, val>{};
     }
 
     // constexpr auto operator= (field_type auto val) const -> detail::field_assignment_rt<field> {
@@ -536,43 +688,46 @@ struct field {
     // [TODO] create concept
     template <typename T>
     requires (std::unsigned_integral<T> &&
-              std::is_convertible_v<T, value_type> &&
-              std::numeric_limits<T>::digits >= msb.value - lsb.value)
-    constexpr auto operator= (T const& rhs) const -> detail::field_assignment_rt<field> {
+              std::is_convertible_v<T, typename Field::value_type> &&
+              std::numeric_limits<T>::digits >= Field::length)
+    constexpr auto operator= (T const& rhs) const -> field_assignment_rt<Field> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::W)) != 0, 
             "Cannot write non-writable field");
         static_assert(
-            std::numeric_limits<value_type>::digits >= 
+            std::numeric_limits<typename Field::value_type>::digits >= 
             std::numeric_limits<T>::digits, 
             "Assigned value type is wider than the base field type");
 
-        return detail::field_assignment_rt<field>{runtime_check(rhs)};
+        return field_assignment_rt<Field>{Field::runtime_check(rhs)};
     }
 
     template <typename T>
     requires (std::unsigned_integral<T> &&
-              std::is_convertible_v<T, value_type> &&
-              std::numeric_limits<T>::digits >= msb.value - lsb.value)
-    constexpr auto operator= (T && rhs) const -> detail::field_assignment_rt<field> {
+              std::is_convertible_v<T, typename Field::value_type> &&
+              std::numeric_limits<T>::digits >= Field::length)
+    constexpr auto operator= (T && rhs) const -> field_assignment_rt<Field> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::W)) != 0, 
             "Cannot write non-writable field");
         static_assert(
-            std::numeric_limits<value_type>::digits >= 
+            std::numeric_limits<typename Field::value_type>::digits >= 
             std::numeric_limits<T>::digits, 
             "Assigned value type is wider than the base field type");
         
-        return detail::field_assignment_rt<field>{runtime_check(rhs)};
+        return field_assignment_rt<Field>{Field::runtime_check(rhs)};
     }
 
     template <typename EnumT>
     requires (std::is_enum_v<EnumT>)
-    constexpr auto operator= (EnumT val) const -> detail::field_assignment_rt<field> {
+    constexpr auto operator= (EnumT val) const -> field_assignment_rt<Field> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::W)) != 0, 
             "Cannot write non-writable field");
         static_assert(
@@ -580,51 +735,86 @@ struct field {
             std::numeric_limits<std::underlying_type_t<EnumT>>::digits, 
             "Underling enum type is wider than the base field type");
 
-        return detail::field_assignment_rt<field>{runtime_check(val)};
+        return field_assignment_rt<Field>{Field::runtime_check(val)};
     }
 
-    constexpr auto read() const -> detail::field_read<field> {
+    constexpr auto read() const -> field_read<Field> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::R)) != 0, 
             "Cannot read non-readable field");
 
-        return detail::field_read<field>{};
+        return field_read<Field>{};
     }
 
-    constexpr auto operator() (std::invocable<value_type> auto f) const -> detail::field_assignment_invocable<decltype(f), field, field> {
+    template <typename F>
+    requires std::invocable<F, typename Field::value_type>
+    constexpr auto operator() (F f) const -> field_assignment_invocable<F, Field, Field> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::RW)) == 
             static_cast<value_type_r>(access_type::RW),
             "Invocable write requires RW field access_type");
 
-        return detail::field_assignment_invocable<decltype(f), field, field>{f};
+        return field_assignment_invocable<F, Field, Field>{f};
     }
 
     template <typename F, typename Field0, typename... Fields>
     requires std::invocable<F, typename Field0::value_type, typename Fields::value_type...>
-    constexpr auto operator() (F f, Field0 f0, Fields... fs) const -> detail::field_assignment_invocable<F, field, Field0, Fields...> {
+    constexpr auto operator() (F f, Field0, Fields...) const -> field_assignment_invocable<F, Field, Field0, Fields...> {
+        using value_type_r = typename Field::value_type_r;
         static_assert((
-            static_cast<value_type_r>(access) & 
+            static_cast<value_type_r>(Field::access) & 
             static_cast<value_type_r>(access_type::RW)) == 
             static_cast<value_type_r>(access_type::RW),
             "Invocable write requires RW field access_type");
 
-        return detail::field_assignment_invocable<F, field, Field0, Fields...>{f};
+        return field_assignment_invocable<F, Field, Field0, Fields...>{f};
     }
+};
+} // namespace ros::detail
+
+template <typename reg_derived, 
+          detail::msb msb, detail::lsb lsb, 
+          access_type at, 
+          detail::field_type value_type_f = typename reg_derived::value_type>
+requires detail::field_selectable<value_type_f, msb, lsb>
+struct field : detail::field_operations_handler<field<reg_derived, msb, lsb, at, value_type_f>> {
+    using value_type_r = typename reg_derived::value_type;
+    using value_type = value_type_f;
+    using reg = reg_derived;
+
+    using detail::field_operations_handler<field>::operator=;
+
+    static constexpr access_type access = at;
+
+    static constexpr uint8_t length = []() {
+        return msb.value == lsb.value ? 1 : msb.value - lsb.value;
+    }();
+
+    // constants are declared with the register type spelled out, naming them
+    // through the member alias makes GCC's instantiation time grow
+    // quadratically with the number of fields in a translation unit
+    static constexpr typename reg_derived::value_type mask = 
+        detail::field_mask<typename reg_derived::value_type>(msb.value, lsb.value);
+
+    static constexpr typename reg_derived::value_type max_value = mask >> lsb.value;
+
+    constexpr field() = default;
 
     static constexpr value_type_r to_reg (value_type_r reg_value, value_type value) {
         return (reg_value & ~mask) | (static_cast<value_type_r>(value) << lsb.value) & mask;
     }
 
     static constexpr value_type to_field (value_type_r value) {
-        return (static_cast<value_type_r>(value) & mask) >> lsb.value;
+        return static_cast<value_type>((static_cast<value_type_r>(value) & mask) >> lsb.value);
     }
 
     static constexpr value_type runtime_check (value_type value) {
         value_type safe_val;
-        if (static_cast<value_type_r>(value) <= mask >> lsb.value) {
+        if (static_cast<value_type_r>(value) <= max_value) {
             safe_val = value;
         } else {
             safe_val = error::handle_field_error<field>(value);
@@ -636,6 +826,129 @@ struct field {
     static constexpr detail::unsafe_field_operations_handler<field> unsafe{};
 };
 
+// bits [msb:lsb] of a disjoint field, same bit range convention as field
+template <detail::msb msb, detail::lsb lsb>
+struct field_segment {
+    static constexpr auto msb_v = msb;
+    static constexpr auto lsb_v = lsb;
+
+    template <typename T>
+    static constexpr T mask = detail::field_mask<T>(msb.value, lsb.value);
+
+    template <typename T>
+    static constexpr unsigned length = std::popcount(mask<T>);
+};
+
+// Field made of several bit ranges of a register. The first segment holds the
+// least significant bits of the field value. Values are scattered to and
+// gathered from the segments with one branch-free expression, PDEP/PEXT
+// when BMI2 is available and segments are listed from low to high bits.
+template <typename reg_derived, access_type at, typename... segments>
+requires (sizeof...(segments) > 0) && 
+         (detail::field_selectable<typename reg_derived::value_type, segments::msb_v, segments::lsb_v> && ...)
+struct disjoint_field : detail::field_operations_handler<disjoint_field<reg_derived, at, segments...>> {
+    using value_type_r = typename reg_derived::value_type;
+    using value_type = value_type_r;
+    using reg = reg_derived;
+
+    using detail::field_operations_handler<disjoint_field>::operator=;
+
+    static constexpr access_type access = at;
+
+    static constexpr value_type_r mask = (segments::template mask<value_type_r> | ...);
+
+    static constexpr uint8_t length = (segments::template length<value_type_r> + ...);
+
+    static_assert(length == std::popcount(mask), "Field segments overlap");
+
+    static constexpr value_type_r max_value = 
+        length == std::numeric_limits<value_type_r>::digits ? 
+            static_cast<value_type_r>(~value_type_r{0}) : 
+            static_cast<value_type_r>((value_type_r{1} << length % std::numeric_limits<value_type_r>::digits) - 1);
+
+    constexpr disjoint_field() = default;
+
+private:
+    static constexpr std::array<unsigned, sizeof...(segments)> lsbs{segments::lsb_v.value...};
+    static constexpr std::array<value_type_r, sizeof...(segments)> masks{segments::template mask<value_type_r>...};
+
+    // position of each segment within the field value
+    static constexpr std::array<unsigned, sizeof...(segments)> offsets = []() {
+        constexpr std::array<unsigned, sizeof...(segments)> lengths{segments::template length<value_type_r>...};
+        std::array<unsigned, sizeof...(segments)> o{};
+        for (std::size_t i = 1; i < o.size(); ++i) {
+            o[i] = o[i-1] + lengths[i-1];
+        }
+        return o;
+    }();
+
+    // PDEP/PEXT map value bits to mask bits from low to high
+    static constexpr bool in_bit_order = []() {
+        for (std::size_t i = 1; i < lsbs.size(); ++i) {
+            if (lsbs[i-1] >= lsbs[i]) return false;
+        }
+        return true;
+    }();
+
+    static constexpr value_type_r scatter (value_type_r value) {
+#if defined(__BMI2__)
+        if constexpr (in_bit_order and std::numeric_limits<value_type_r>::digits <= 64) {
+            if (not std::is_constant_evaluated()) {
+                if constexpr (std::numeric_limits<value_type_r>::digits <= 32) {
+                    return static_cast<value_type_r>(_pdep_u32(value, mask));
+                } else {
+                    return static_cast<value_type_r>(_pdep_u64(value, mask));
+                }
+            }
+        }
+#endif
+        return [value]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return static_cast<value_type_r>(
+                (((value >> offsets[Is] << lsbs[Is]) & masks[Is]) | ...));
+        }(std::index_sequence_for<segments...>{});
+    }
+
+    static constexpr value_type_r gather (value_type_r value) {
+#if defined(__BMI2__)
+        if constexpr (in_bit_order and std::numeric_limits<value_type_r>::digits <= 64) {
+            if (not std::is_constant_evaluated()) {
+                if constexpr (std::numeric_limits<value_type_r>::digits <= 32) {
+                    return static_cast<value_type_r>(_pext_u32(value, mask));
+                } else {
+                    return static_cast<value_type_r>(_pext_u64(value, mask));
+                }
+            }
+        }
+#endif
+        return [value]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return static_cast<value_type_r>(
+                (((value & masks[Is]) >> lsbs[Is] << offsets[Is]) | ...));
+        }(std::index_sequence_for<segments...>{});
+    }
+
+public:
+    static constexpr value_type_r to_reg (value_type_r reg_value, value_type value) {
+        return (reg_value & ~mask) | scatter(value);
+    }
+
+    static constexpr value_type to_field (value_type_r value) {
+        return gather(value);
+    }
+
+    static constexpr value_type runtime_check (value_type value) {
+        value_type safe_val;
+        if (value <= max_value) {
+            safe_val = value;
+        } else {
+            safe_val = error::handle_field_error<disjoint_field>(value);
+        }
+
+        return safe_val;
+    }
+
+    static constexpr detail::unsafe_field_operations_handler<disjoint_field> unsafe{};
+};
+
 // file: field.hpp
 namespace detail {
 // definitions of operations
@@ -728,106 +1041,521 @@ struct bus {
     static T read(Addr address);
     template <typename T, typename Addr>
     static void write(T val, Addr address);
-    template <typename... AdjacentAddrs, typename... ValueTypes>
-    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...> addrs);
-    template <typename... AdjacentAddrs, typename... ValueTypes>
-    static void write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values);
+    // optional, not declared here so that apply can detect them: bursts over
+    // registers at adjacent addresses, one access per register otherwise,
+    //   template <typename... ValueTypes, typename... AdjacentAddrs>
+    //   static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...> addrs);
+    //   template <typename... AdjacentAddrs, typename... ValueTypes>
+    //   static void write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values);
+    // optional, required by policy::cas. on failure expected receives the current value
+    template <typename T, typename Addr>
+    static bool compare_exchange(T& expected, T desired, Addr address);
+    // byte enables: an 8 or 16 bit write to a register only changes its own
+    // lanes, lane k of a register at address + k (little-endian)
+    static constexpr bool byte_lanes = false;
+    // typed hooks: Bus::count<access_event, T>() is called for every register
+    // and field an apply touches, see profiling_bus
+    static constexpr bool profiled = false;
+    // optional, not declared here so that sequence can detect it: a bulk
+    // writer such as a DMA channel,
+    //   template <typename T> static void write_table(std::span<table_write<T> const> table);
 };
 
-// file: register.hpp
-template <typename reg_derived, detail::register_type T, detail::addr addr, typename bus_t>
-struct reg {
-    using reg_der = reg_derived;
-    using value_type = T;
-    using bus = bus_t;
-    using address = std::integral_constant<std::size_t, addr.value>;
-
-    static constexpr value_type layout = detail::get_rmw_mask(reg_der{});
-    static constexpr bool has_wo_field = detail::check_wo_fields(reg_der{});
-    static constexpr bool has_ro_field = detail::check_ro_fields(reg_der{});
-
-    static constexpr ros::detail::unsafe_register_operations_handler<reg> unsafe{};
-    static constexpr ros::detail::safe_register_operations_handler<reg> self{};
-};
+// file: ring.hpp
+namespace detail {
 
-// file: literals.hpp
-namespace literals {
-template <char ...Chars>
-constexpr auto operator""_f () {
-    using T = std::size_t; // platform max
-    constexpr T new_value = ros::detail::to_constant<T, Chars...>();
-    
-    // std::cout << "<new value>_f = " << new_value << std::endl;
+// Last N records of a log, e.g. errors or bus transactions. Writers never
+// block: a record gets a ticket and is published through its slot's sequence
+// number, 2 * ticket + 2 once complete. Several writers claim the slot first
+// by making the number odd; a writer whose slot is still being filled by a
+// writer N tickets earlier, or was already taken by a later one, drops its
+// record. A single writer takes tickets and slots with plain loads and
+// stores, the ticket counter tells readers a slot is being reused. Readers
+// accept a copy only if the slot is still the record's and no writer has
+// reused it meanwhile, so they never see a torn one. Records are kept in
+// atomic words, there's no data race on them.
+template <typename Record, std::size_t N, bool multi_writer = true>
+class seq_ring {
+    static_assert((N & (N - 1)) == 0, "ring size must be a power of two");
+    static_assert(std::is_trivially_copyable_v<Record>, "records are copied word by word");
+
+    static constexpr std::size_t words = (sizeof(Record) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::array<std::atomic<std::uint64_t>, words> data{};
+    };
 
-    return detail::field_value<T, new_value>{};
-}
+public:
+    // tickets handed out so far, the last min(count(), N) may be in the ring
+    std::uint64_t count() const {
+        return head_.load(std::memory_order_acquire);
+    }
 
-template <char ...Chars>
-constexpr auto operator""_r () {
-    using T = std::size_t; // platform max
-    constexpr T new_value = ros::detail::to_constant<T, Chars...>();
-    
-    // std::cout << "<new value>_f = " << new_value << std::endl;
+    // records given up because their slot was busy
+    std::uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
 
-    return detail::register_value<T, new_value>{};
-}
+    void push(Record const& record) {
+        std::uint64_t ticket;
+        if constexpr (multi_writer) {
+            ticket = head_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ticket = head_.load(std::memory_order_relaxed);
+            head_.store(ticket + 1, std::memory_order_relaxed);
+        }
 
-template <char ...Chars>
-constexpr auto operator""_msb () {
-    constexpr unsigned new_value = ros::detail::to_constant<unsigned, Chars...>();
+        auto& s = slots_[ticket & (N - 1)];
+        const std::uint64_t filling = 2 * ticket + 1;
+        if constexpr (multi_writer) {
+            std::uint64_t seq = s.seq.load(std::memory_order_relaxed);
+            do {
+                if ((seq & 1) != 0 or seq > filling) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            } while (not s.seq.compare_exchange_weak(seq, filling, std::memory_order_relaxed));
+        }
+        // orders the claim (or the ticket) before the record
+        std::atomic_thread_fence(std::memory_order_release);
 
-    return detail::msb<unsigned, new_value>{};
-}
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (s.data[Is].store(word<Is>(record), std::memory_order_relaxed), ...);
+        }(std::make_index_sequence<words>{});
+        s.seq.store(filling + 1, std::memory_order_release);
+    }
 
-template <char ...Chars>
-constexpr auto operator""_lsb () {
-    constexpr unsigned new_value = ros::detail::to_constant<unsigned, Chars...>();
+    // the record of a ticket, if it's complete and not overwritten yet
+    std::optional<Record> read(std::uint64_t ticket) const {
+        auto const& s = slots_[ticket & (N - 1)];
+        const std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+        if (seq != 2 * ticket + 2) {
+            return std::nullopt;
+        }
+        std::array<std::uint64_t, words> raw;
+        for (std::size_t i = 0; i < words; ++i) {
+            raw[i] = s.data[i].load(std::memory_order_relaxed);
+        }
+        // a writer reusing the slot, whose words we may have copied, has
+        // changed its sequence number or taken ticket + N by now
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) != seq or head_.load(std::memory_order_relaxed) > ticket + N) {
+            return std::nullopt;
+        }
+        std::array<std::byte, sizeof(Record)> bytes;
+        std::memcpy(bytes.data(), raw.data(), sizeof(Record));
+        return std::bit_cast<Record>(bytes);
+    }
 
-    return detail::lsb<unsigned, new_value>{};
-}
+    // complete records still in the ring, oldest first
+    std::vector<Record> snapshot() const {
+        const auto end = count();
+        const auto begin = end > N ? end - N : 0;
+        std::vector<Record> out;
+        out.reserve(end - begin);
+        for (auto ticket = begin; ticket < end; ++ticket) {
+            if (auto record = read(ticket)) {
+                out.push_back(*record);
+            }
+        }
+        return out;
+    }
 
-template <char ...Chars>
-constexpr auto operator""_addr () {
-    constexpr std::size_t new_value = ros::detail::to_constant<std::size_t, Chars...>();
+    // only while no writer is active
+    void clear() {
+        for (auto& s : slots_) {
+            s.seq.store(0, std::memory_order_relaxed);
+        }
+        dropped_.store(0, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_release);
+    }
 
-    return detail::addr<std::size_t, new_value>{};
-}
-} // namespace ros::literals
+private:
+    // word I of a record, zero-extended past its end
+    template <std::size_t I>
+    static std::uint64_t word(Record const& record) {
+        constexpr std::size_t size = std::min(sizeof(std::uint64_t), sizeof(Record) - I * sizeof(std::uint64_t));
+        std::uint64_t w = 0;
+        std::memcpy(&w, reinterpret_cast<char const*>(&record) + I * sizeof(std::uint64_t), size);
+        return w;
+    }
 
-// file: filter.hpp
-namespace detail {
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::array<slot, N> slots_{};
+};
+} // namespace ros::detail
 
-template <typename ...Is>
-struct index_sequence_concat;
+// file: policy.hpp
+namespace policy {
+// policy categories. a register picks at most one policy of each category,
+// the first one listed wins
+struct cache {};
 
-template <std::size_t... Ls>
-struct index_sequence_concat<std::index_sequence<Ls...>> {
-    using type = std::index_sequence<Ls...>;
+struct no_cache : cache {
+    static constexpr bool enabled = false;
 };
 
-template <std::size_t... Ls, std::size_t... Rs>
-struct index_sequence_concat<std::index_sequence<Ls...>, std::index_sequence<Rs...>> {
-    using type = std::index_sequence<Ls..., Rs...>;
+// keeps the last value written to the register so partial writes don't
+// have to read it back from the bus
+struct shadow_cache : cache {
+    static constexpr bool enabled = true;
 };
 
-template <typename Is0, typename Is1, typename ...Is>
-struct index_sequence_concat<Is0, Is1, Is...> {
-    using type = typename index_sequence_concat<
-        typename index_sequence_concat<Is0, Is1>::type, Is...>
-        ::type;
-};
+// how the read-modify-write sequence is protected against concurrent updates
+struct concurrency {};
 
-template <typename ...Is>
-using index_sequence_concat_t = typename index_sequence_concat<Is...>::type;
+// no protection, zero cost. for registers owned by a single context
+struct no_lock : concurrency {};
 
-template <bool B, std::size_t I>
-struct conditional_index_sequence {
-    using type = std::index_sequence<>;
-};
+// retries the update with bus::compare_exchange until no one interfered
+struct cas : concurrency {};
 
-template <std::size_t I>
-struct conditional_index_sequence<true, I> {
-    using type = std::index_sequence<I>;
+// per-register spin lock, for buses without an atomic compare-exchange
+struct spin_lock : concurrency {};
+
+// where out-of-range field values and read-only bit assignments are reported.
+// the value itself is corrected by the handlers in error.hpp either way
+struct errors {};
+
+// error reporting off
+struct error_silent : errors {
+    template <typename Reg>
+    static void report(std::uint64_t, std::uint64_t) {}
+};
+
+// counts errors per register
+struct error_counter : errors {
+    template <typename Reg>
+    static inline std::atomic<std::uint64_t> count{0};
+
+    template <typename Reg>
+    static void report(std::uint64_t, std::uint64_t) {
+        count<Reg>.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// keeps the last N error records of all registers sharing the ring.
+// writers never block, see detail::seq_ring
+template <std::size_t N = 64>
+struct error_ring : errors {
+    static inline detail::seq_ring<error::record, N> ring{};
+
+    // errors reported so far, the last min(count(), N) can be read back
+    static std::size_t count() {
+        return ring.count();
+    }
+
+    // error number i, unless it was overwritten or is still being written
+    static std::optional<error::record> read(std::size_t i) {
+        return ring.read(i);
+    }
+
+    // the records still in the ring, oldest first
+    static std::vector<error::record> snapshot() {
+        return ring.snapshot();
+    }
+
+    template <typename Reg>
+    static void report(std::uint64_t mask, std::uint64_t value) {
+        const auto timestamp = static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        ring.push(error::record{Reg::address::value, mask, value, timestamp});
+    }
+};
+
+// stops right at the faulty access, for debugging
+struct error_trap : errors {
+    template <typename Reg>
+    static void report(std::uint64_t, std::uint64_t) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_trap();
+#else
+        std::abort();
+#endif
+    }
+};
+
+// alias addresses next to a register that set, clear or toggle the bits
+// written to them, at the given offsets from the register address. writes
+// through them need no read and can't lose concurrent updates of other bits
+struct aliases {};
+
+struct no_aliases : aliases {
+    static constexpr bool enabled = false;
+    static constexpr std::size_t set = 0;
+    static constexpr std::size_t clear = 0;
+    static constexpr std::size_t toggle = 0;
+};
+
+// e.g. alias_registers<0x4, 0x8, 0xc>, no toggle alias with a 0 offset
+template <std::size_t Set, std::size_t Clear, std::size_t Toggle = 0>
+struct alias_registers : aliases {
+    static_assert(Set != 0 and Clear != 0, "set and clear aliases are required");
+    static constexpr bool enabled = true;
+    static constexpr std::size_t set = Set;
+    static constexpr std::size_t clear = Clear;
+    static constexpr std::size_t toggle = Toggle;
+};
+} // namespace ros::policy
+
+namespace detail {
+template <typename Category, typename Default, typename... Policies>
+struct select_policy {
+    using type = Default;
+};
+
+template <typename Category, typename Default, typename Policy, typename... Policies>
+struct select_policy<Category, Default, Policy, Policies...> {
+    using type = std::conditional_t<
+        std::is_base_of_v<Category, Policy>,
+        Policy,
+        typename select_policy<Category, Default, Policies...>::type>;
+};
+
+template <typename Category, typename Default, typename... Policies>
+using select_policy_t = typename select_policy<Category, Default, Policies...>::type;
+} // namespace ros::detail
+
+// file: register.hpp
+template <typename reg_derived, detail::register_type T, detail::addr addr, typename bus_t, typename... policies>
+struct reg {
+    using reg_der = reg_derived;
+    using value_type = T;
+    using bus = bus_t;
+    using address = std::integral_constant<std::size_t, addr.value>;
+    using cache_policy = detail::select_policy_t<policy::cache, policy::no_cache, policies...>;
+    using concurrency_policy = detail::select_policy_t<policy::concurrency, policy::no_lock, policies...>;
+    using error_policy = detail::select_policy_t<policy::errors, policy::error_counter, policies...>;
+    using alias_policy = detail::select_policy_t<policy::aliases, policy::no_aliases, policies...>;
+
+    static constexpr value_type layout = detail::get_rmw_mask(reg_der{});
+    static constexpr bool has_wo_field = detail::check_wo_fields(reg_der{});
+    static constexpr bool has_ro_field = detail::check_ro_fields(reg_der{});
+    static constexpr bool has_side_effect_field = detail::check_side_effect_fields(reg_der{});
+
+    // bits acting when written (clear or set on 0 or 1), and the value that
+    // leaves them alone: ones for write-0-to-clear, zeros for the others.
+    // only the remaining readable bits have to be read back in an rmw
+    static constexpr value_type side_effect_mask = 
+        detail::get_access_mask(reg_der{}, access_type::RW_0C) |
+        detail::get_access_mask(reg_der{}, access_type::RW_1C) |
+        detail::get_access_mask(reg_der{}, access_type::RW_1S);
+    static constexpr value_type idle_value = detail::get_access_mask(reg_der{}, access_type::RW_0C);
+    static constexpr value_type preserved_mask = layout & ~side_effect_mask;
+
+    // only registers made of plain RW fields hold exactly what was last
+    // written to them, anything else silently opts out of the shadow cache.
+    // lock-free updates always start from the bus value
+    static constexpr bool is_shadowed = 
+        cache_policy::enabled and
+        not has_ro_field and
+        not has_wo_field and
+        not has_side_effect_field and
+        not std::is_same_v<concurrency_policy, policy::cas>;
+
+    static constexpr ros::detail::unsafe_register_operations_handler<reg> unsafe{};
+    static constexpr ros::detail::safe_register_operations_handler<reg> self{};
+};
+
+// file: cache.hpp
+namespace detail {
+
+// keyed by bus and address so field and register operations share the copy
+template <typename Bus, std::size_t Address, typename T>
+struct shadow {
+    static inline T value{};
+    static inline bool valid = false;
+};
+
+template <typename Reg>
+using shadow_t = shadow<typename Reg::bus, Reg::address::value, typename Reg::value_type>;
+
+template <typename Reg>
+void shadow_store(typename Reg::value_type value) {
+    if constexpr (Reg::is_shadowed) {
+        shadow_t<Reg>::value = value;
+        shadow_t<Reg>::valid = true;
+    }
+}
+
+template <typename Reg>
+auto bus_read() -> typename Reg::value_type {
+    auto value = Reg::bus::template read<typename Reg::value_type>(Reg::address::value);
+    shadow_store<Reg>(value);
+    return value;
+}
+
+// value a read-modify-write starts from. shadowed registers are read from
+// the bus only once, until then nothing is known about their content
+template <typename Reg>
+auto rmw_read() -> typename Reg::value_type {
+    if constexpr (Reg::is_shadowed) {
+        if (shadow_t<Reg>::valid) {
+            return shadow_t<Reg>::value;
+        }
+    }
+    return bus_read<Reg>();
+}
+
+template <typename Reg>
+void bus_write(typename Reg::value_type value) {
+    Reg::bus::write(value, Reg::address::value);
+    shadow_store<Reg>(value);
+}
+
+// value read back for an rmw with the side-effect bits that aren't written
+// set to their idle value, so pending W1C bits aren't cleared by accident
+template <typename Reg>
+constexpr auto write_back(typename Reg::value_type value, typename Reg::value_type written) -> typename Reg::value_type {
+    const typename Reg::value_type idle = Reg::side_effect_mask & ~written;
+    return (value & ~idle) | (Reg::idle_value & idle);
+}
+
+// the fields of Reg that differ between two register values, whole fields.
+// a register invocable returns the whole register, the fields it changed
+// from what it read are the ones it writes
+template <typename Reg>
+constexpr auto changed_fields(typename Reg::value_type old, typename Reg::value_type value) -> typename Reg::value_type {
+    using value_type = typename Reg::value_type;
+    const value_type diff = old ^ value;
+    return std::apply([diff](auto... fields) {
+        return (value_type{0} | ... | ((diff & decltype(fields)::mask) != 0 ? decltype(fields)::mask : value_type{0}));
+    }, reflect::to_tuple(typename Reg::reg_der{}));
+}
+} // namespace ros::detail
+
+// file: concurrency.hpp
+namespace detail {
+
+template <typename Bus, std::size_t Address>
+struct register_lock {
+    static inline std::atomic_flag flag{};
+
+    register_lock() {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+            while (flag.test(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    ~register_lock() {
+        flag.clear(std::memory_order_release);
+    }
+};
+
+template <typename Reg>
+using register_lock_t = register_lock<typename Reg::bus, Reg::address::value>;
+
+// Writes update(old) to the register according to its concurrency policy and
+// returns the written value. Without needs_read update gets a zero value and
+// the result is simply written. With policy::cas update may be called more
+// than once, so it must not have side effects.
+template <typename Reg, bool needs_read, typename F>
+auto read_modify_write(F update) -> typename Reg::value_type {
+    using value_type = typename Reg::value_type;
+    using concurrency = typename Reg::concurrency_policy;
+
+    if constexpr (std::is_same_v<concurrency, policy::cas> and needs_read) {
+        value_type expected = Reg::bus::template read<value_type>(Reg::address::value);
+        value_type desired;
+        do {
+            desired = update(expected);
+        } while (not Reg::bus::compare_exchange(expected, desired, Reg::address::value));
+        return desired;
+    } else if constexpr (std::is_same_v<concurrency, policy::spin_lock>) {
+        register_lock_t<Reg> lock{};
+        value_type value = update(needs_read ? rmw_read<Reg>() : value_type{});
+        bus_write<Reg>(value);
+        return value;
+    } else {
+        value_type value = update(needs_read ? rmw_read<Reg>() : value_type{});
+        bus_write<Reg>(value);
+        return value;
+    }
+}
+} // namespace ros::detail
+
+// file: literals.hpp
+namespace literals {
+template <char ...Chars>
+constexpr auto operator""_f () {
+    using T = std::size_t; // platform max
+    constexpr T new_value = ros::detail::to_constant<T, Chars...>();
+    
+    // std::cout << "<new value>_f = " << new_value << std::endl;
+
+    return detail::field_value<T, new_value>{};
+}
+
+template <char ...Chars>
+constexpr auto operator""_r () {
+    using T = std::size_t; // platform max
+    constexpr T new_value = ros::detail::to_constant<T, Chars...>();
+    
+    // std::cout << "<new value>_f = " << new_value << std::endl;
+
+    return detail::register_value<T, new_value>{};
+}
+
+template <char ...Chars>
+constexpr auto operator""_msb () {
+    constexpr unsigned new_value = ros::detail::to_constant<unsigned, Chars...>();
+
+    return detail::msb<unsigned, new_value>{};
+}
+
+template <char ...Chars>
+constexpr auto operator""_lsb () {
+    constexpr unsigned new_value = ros::detail::to_constant<unsigned, Chars...>();
+
+    return detail::lsb<unsigned, new_value>{};
+}
+
+template <char ...Chars>
+constexpr auto operator""_addr () {
+    constexpr std::size_t new_value = ros::detail::to_constant<std::size_t, Chars...>();
+
+    return detail::addr<std::size_t, new_value>{};
+}
+} // namespace ros::literals
+
+// file: filter.hpp
+namespace detail {
+
+template <typename ...Is>
+struct index_sequence_concat;
+
+template <std::size_t... Ls>
+struct index_sequence_concat<std::index_sequence<Ls...>> {
+    using type = std::index_sequence<Ls...>;
+};
+
+template <std::size_t... Ls, std::size_t... Rs>
+struct index_sequence_concat<std::index_sequence<Ls...>, std::index_sequence<Rs...>> {
+    using type = std::index_sequence<Ls..., Rs...>;
+};
+
+template <typename Is0, typename Is1, typename ...Is>
+struct index_sequence_concat<Is0, Is1, Is...> {
+    using type = typename index_sequence_concat<
+        typename index_sequence_concat<Is0, Is1>::type, Is...>
+        ::type;
+};
+
+template <typename ...Is>
+using index_sequence_concat_t = typename index_sequence_concat<Is...>::type;
+
+template <bool B, std::size_t I>
+struct conditional_index_sequence {
+    using type = std::index_sequence<>;
+};
+
+template <std::size_t I>
+struct conditional_index_sequence<true, I> {
+    using type = std::index_sequence<I>;
 };
 
 template <bool B, std::size_t I>
@@ -862,6 +1590,202 @@ constexpr auto tuple_filter(const Tuple& tuple) {
 }
 } // namespace ros::detail
 
+// file: burst.hpp
+namespace detail {
+
+// position of the register living at the same bus and address as Reg
+template <typename Reg, typename... Regs>
+constexpr std::size_t register_index() {
+    constexpr std::array<bool, sizeof...(Regs)> same{(
+        std::is_same_v<typename Reg::bus, typename Regs::bus> and
+        Reg::address::value == Regs::address::value)...
+    };
+    std::size_t i = 0;
+    while (i < same.size() and not same[i]) ++i;
+    return i;
+}
+
+// Compile-time schedule of bus transactions for a set of registers. Registers
+// are sorted by address and cut into runs of adjacent registers, i.e. the next
+// register starts right where the previous one ends and both sit on the same
+// bus. Each run is issued as a single (burst) bus transaction.
+template <typename... Regs>
+struct burst_plan {
+    static constexpr std::size_t size = sizeof...(Regs);
+
+    static constexpr std::array<std::size_t, size> addresses{Regs::address::value...};
+    static constexpr std::array<std::size_t, size> widths{sizeof(typename Regs::value_type)...};
+    static constexpr std::array<std::size_t, size> buses{
+        []<typename Bus>(std::type_identity<Bus>) -> std::size_t {
+            constexpr std::array<bool, size> same{std::is_same_v<Bus, typename Regs::bus>...};
+            std::size_t i = 0;
+            while (not same[i]) ++i;
+            return i;
+        }(std::type_identity<typename Regs::bus>{})...
+    };
+
+    // argument positions sorted by address, ties keep the argument order
+    static constexpr std::array<std::size_t, size> order = []() {
+        std::array<std::size_t, size> o{};
+        for (std::size_t i = 0; i < size; ++i) {
+            o[i] = i;
+        }
+        for (std::size_t i = 1; i < size; ++i) {
+            for (std::size_t j = i; j > 0 and addresses[o[j-1]] > addresses[o[j]]; --j) {
+                std::swap(o[j-1], o[j]);
+            }
+        }
+        return o;
+    }();
+
+    // sorted position of each argument, inverse of order
+    static constexpr std::array<std::size_t, size> position = []() {
+        std::array<std::size_t, size> p{};
+        for (std::size_t k = 0; k < size; ++k) {
+            p[order[k]] = k;
+        }
+        return p;
+    }();
+
+    static constexpr bool adjacent(std::size_t prev, std::size_t next) {
+        return buses[prev] == buses[next] and
+               addresses[prev] + widths[prev] == addresses[next];
+    }
+
+    // run_start[r] is the sorted position where run r begins, run_start[runs] == size
+    static constexpr std::size_t runs = []() {
+        std::size_t n = size > 0 ? 1 : 0;
+        for (std::size_t k = 1; k < size; ++k) {
+            if (not adjacent(order[k-1], order[k])) ++n;
+        }
+        return n;
+    }();
+
+    static constexpr std::array<std::size_t, runs + 1> run_start = []() {
+        std::array<std::size_t, runs + 1> rs{};
+        std::size_t r = 0;
+        for (std::size_t k = 1; k < size; ++k) {
+            if (not adjacent(order[k-1], order[k])) rs[++r] = k;
+        }
+        rs[runs] = size;
+        return rs;
+    }();
+
+    static constexpr std::size_t run_length(std::size_t r) {
+        return run_start[r+1] - run_start[r];
+    }
+};
+
+// whether Bus declares the burst overloads for these registers
+template <typename Bus, typename Values, typename Addrs>
+struct has_burst_read : std::false_type {};
+
+template <typename Bus, typename... ValueTypes, typename... AdjacentAddrs>
+requires requires(std::tuple<AdjacentAddrs...> addrs) { Bus::template read<ValueTypes...>(addrs); }
+struct has_burst_read<Bus, std::tuple<ValueTypes...>, std::tuple<AdjacentAddrs...>> : std::true_type {};
+
+template <typename Bus, typename Addrs, typename Values>
+struct has_burst_write : std::false_type {};
+
+template <typename Bus, typename... AdjacentAddrs, typename... ValueTypes>
+requires requires(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values) {
+    Bus::template write<AdjacentAddrs...>(addrs, values);
+}
+struct has_burst_write<Bus, std::tuple<AdjacentAddrs...>, std::tuple<ValueTypes...>> : std::true_type {};
+
+template <typename Bus, typename Values, typename Addrs>
+concept burst_read_bus = has_burst_read<Bus, Values, Addrs>::value;
+
+template <typename Bus, typename Addrs, typename Values>
+concept burst_write_bus = has_burst_write<Bus, Addrs, Values>::value;
+
+// one burst when Bus has them, one access per register otherwise
+template <typename Bus, typename... ValueTypes, typename... AdjacentAddrs>
+constexpr auto burst_read(std::tuple<AdjacentAddrs...> addrs) -> std::tuple<ValueTypes...> {
+    if constexpr (burst_read_bus<Bus, std::tuple<ValueTypes...>, std::tuple<AdjacentAddrs...>>) {
+        return Bus::template read<ValueTypes...>(addrs);
+    } else {
+        // braced initialization keeps the address order
+        return std::tuple<ValueTypes...>{Bus::template read<ValueTypes>(AdjacentAddrs::value)...};
+    }
+}
+
+template <typename Bus, typename... AdjacentAddrs, typename... ValueTypes>
+constexpr void burst_write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values) {
+    if constexpr (burst_write_bus<Bus, std::tuple<AdjacentAddrs...>, std::tuple<ValueTypes...>>) {
+        Bus::template write<AdjacentAddrs...>(addrs, values);
+    } else {
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (Bus::write(std::get<Is>(values), AdjacentAddrs::value), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+    }
+}
+
+template <typename Plan, std::size_t Run, typename Writes, std::size_t... Ks>
+constexpr void write_run(Writes const& ws, std::index_sequence<Ks...>) {
+    constexpr std::size_t first = Plan::order[Plan::run_start[Run]];
+    using bus = typename std::tuple_element_t<first, Writes>::type::bus;
+
+    if constexpr (sizeof...(Ks) == 1) {
+        using reg = typename std::tuple_element_t<first, Writes>::type;
+        bus::write(static_cast<typename reg::value_type>(std::get<first>(ws).value), reg::address::value);
+    } else {
+        burst_write<bus>(
+            std::tuple<typename std::tuple_element_t<Plan::order[Plan::run_start[Run] + Ks], Writes>::type::address...>{},
+            std::make_tuple(
+                static_cast<typename std::tuple_element_t<Plan::order[Plan::run_start[Run] + Ks], Writes>::type::value_type>(
+                    std::get<Plan::order[Plan::run_start[Run] + Ks]>(ws).value)...)
+        );
+    }
+}
+
+template <typename Plan, typename Writes, std::size_t... Runs>
+constexpr void write_runs(Writes const& ws, std::index_sequence<Runs...>) {
+    (write_run<Plan, Runs>(ws, std::make_index_sequence<Plan::run_length(Runs)>{}), ...);
+}
+
+// issues register writes in address order, adjacent registers in one burst
+template <typename... Ws>
+constexpr void write_bursts(std::tuple<Ws...> const& ws) {
+    using plan = burst_plan<typename Ws::type...>;
+    write_runs<plan>(ws, std::make_index_sequence<plan::runs>{});
+}
+
+template <typename Plan, std::size_t Run, typename Regs, std::size_t... Ks>
+constexpr auto read_run(std::index_sequence<Ks...>) {
+    constexpr std::size_t first = Plan::order[Plan::run_start[Run]];
+    using bus = typename std::tuple_element_t<first, Regs>::bus;
+
+    if constexpr (sizeof...(Ks) == 1) {
+        using reg = std::tuple_element_t<first, Regs>;
+        return std::make_tuple(bus::template read<typename reg::value_type>(reg::address::value));
+    } else {
+        return burst_read<bus,
+            typename std::tuple_element_t<Plan::order[Plan::run_start[Run] + Ks], Regs>::value_type...
+        >(std::tuple<typename std::tuple_element_t<Plan::order[Plan::run_start[Run] + Ks], Regs>::address...>{});
+    }
+}
+
+// reads registers in address order, adjacent registers in one burst.
+// values are returned in the order of Regs
+template <typename... Regs>
+constexpr auto read_bursts() -> std::tuple<typename Regs::value_type...> {
+    using plan = burst_plan<Regs...>;
+
+    auto sorted = []<std::size_t... Runs>(std::index_sequence<Runs...>) {
+        // braced initialization issues the runs in address order, function
+        // arguments could be evaluated in any order
+        auto runs = std::tuple<decltype(read_run<plan, Runs, std::tuple<Regs...>>(std::make_index_sequence<plan::run_length(Runs)>{}))...>{
+            read_run<plan, Runs, std::tuple<Regs...>>(std::make_index_sequence<plan::run_length(Runs)>{})...};
+        return std::apply([](auto&... rs) { return std::tuple_cat(rs...); }, runs);
+    }(std::make_index_sequence<plan::runs>{});
+
+    return [&sorted]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return std::make_tuple(std::get<plan::position[Is]>(sorted)...);
+    }(std::index_sequence_for<Regs...>{});
+}
+} // namespace ros::detail
+
 // file: type_traits.hpp
 namespace detail {
 
@@ -1003,38 +1927,151 @@ constexpr T get_invocable_write_value(T value, T mask, std::tuple<> const& tup)
     return value;
 }
 
-template<typename InvocableWrite, std::size_t ...Is>
-constexpr void evaluate_invocable_assignment_helper(InvocableWrite iw, std::index_sequence<Is...>) {
+// Source registers of a set of invocables, each register once. Plain ones
+// are read from the bus in bursts, shadowed ones through their cache
+template <typename Plain, typename Shadowed>
+struct source_set;
+
+template <typename... Ps, typename... Ss>
+struct source_set<std::tuple<Ps...>, std::tuple<Ss...>> {
+    using values = std::pair<std::tuple<typename Ps::value_type...>, std::tuple<typename Ss::value_type...>>;
+
+    static auto read() -> values {
+        return {read_bursts<Ps...>(), std::tuple<typename Ss::value_type...>{rmw_read<Ss>()...}};
+    }
+
+    template <typename Reg>
+    static auto get(values const& vs) -> typename Reg::value_type {
+        if constexpr (Reg::is_shadowed) {
+            return std::get<register_index<Reg, Ss...>()>(vs.second);
+        } else {
+            return std::get<register_index<Reg, Ps...>()>(vs.first);
+        }
+    }
+};
+
+template <typename Plain, typename Shadowed, typename... Regs>
+struct make_source_set {
+    using type = source_set<Plain, Shadowed>;
+};
+
+template <typename... Ps, typename... Ss, typename Reg, typename... Regs>
+struct make_source_set<std::tuple<Ps...>, std::tuple<Ss...>, Reg, Regs...> {
+    static constexpr bool known = register_index<Reg, Ps..., Ss...>() < sizeof...(Ps) + sizeof...(Ss);
+    using plain = std::conditional_t<known or Reg::is_shadowed, std::tuple<Ps...>, std::tuple<Ps..., Reg>>;
+    using shadowed = std::conditional_t<known or not Reg::is_shadowed, std::tuple<Ss...>, std::tuple<Ss..., Reg>>;
+    using type = typename make_source_set<plain, shadowed, Regs...>::type;
+};
+
+template <typename Sources>
+struct source_set_of;
+
+template <typename... Regs>
+struct source_set_of<std::tuple<Regs...>> {
+    using type = typename make_source_set<std::tuple<>, std::tuple<>, Regs...>::type;
+};
+
+template <typename Sources, typename InvocableWrite, std::size_t ...Is>
+auto evaluate_invocable(InvocableWrite iw, typename Sources::values const& values, std::index_sequence<Is...>) {
     using registerOp = typename InvocableWrite::registerOp;
-    using busOp = registerOp::bus;
     using registers = typename InvocableWrite::registers;
+    using value_type = typename registerOp::value_type;
 
-    busOp::write(iw(
-        // call bus::read that corresponds to each register
-        std::tuple_element_t<Is, registers>::bus::template read<
-            typename std::tuple_element_t<Is, registers>::value_type
-        >(std::tuple_element_t<Is, registers>::address::value)
-        ...), 
-        registerOp::address::value
-    );
-}
+    constexpr bool self_referenced = (
+        (register_index<std::tuple_element_t<Is, registers>, registerOp>() == 0) or ...);
 
-template<typename InvocableWrite>
-constexpr void evaluate_invocable_assignment(InvocableWrite iw) {
-    using registers = typename InvocableWrite::registers;
-    evaluate_invocable_assignment_helper(iw, std::make_index_sequence<std::tuple_size_v<registers>>{});
+    const value_type value = iw(Sources::template get<std::tuple_element_t<Is, registers>>(values)...);
+    // side-effect fields passed through unchanged are written idle
+    if constexpr (self_referenced and registerOp::side_effect_mask != 0) {
+        const value_type old = Sources::template get<registerOp>(values);
+        return register_assignment_rt<registerOp>{detail::write_back<registerOp>(value, changed_fields<registerOp>(old, value))};
+    } else {
+        return register_assignment_rt<registerOp>{value};
+    }
 }
 
-template<typename ...InvocableWrites, std::size_t ...Is>
-constexpr void evaluate_invocable_assignments_helper(std::tuple<InvocableWrites...> writes, std::index_sequence<Is...>) {
-    (evaluate_invocable_assignment(std::get<Is>(writes)), ...);
+template <typename InvocableWrite>
+struct is_locked_invocable : std::bool_constant<
+    not std::is_same_v<typename InvocableWrite::registerOp::concurrency_policy, policy::no_lock>> {};
+
+template <typename InvocableWrite>
+struct is_unlocked_invocable : std::bool_constant<not is_locked_invocable<InvocableWrite>::value> {};
+
+// registers an invocable needs from the read phase. a locked destination is
+// read under its policy instead, in the update
+template <typename InvocableWrite, typename Registers = typename InvocableWrite::registers>
+struct read_phase_sources;
+
+template <typename InvocableWrite, typename... Rs>
+struct read_phase_sources<InvocableWrite, std::tuple<Rs...>> {
+    using type = std::conditional_t<is_locked_invocable<InvocableWrite>::value,
+        decltype(std::tuple_cat(std::declval<std::conditional_t<
+            register_index<Rs, typename InvocableWrite::registerOp>() == 0, std::tuple<>, std::tuple<Rs>>>()...)),
+        std::tuple<Rs...>>;
+};
+
+// updates a destination under its concurrency policy. only its own value
+// comes from the update, update may be retried (cas) and must not read the
+// bus again
+template <typename Sources, typename InvocableWrite, std::size_t ...Is>
+void evaluate_locked_invocable(InvocableWrite iw, typename Sources::values const& values, std::index_sequence<Is...>) {
+    using registerOp = typename InvocableWrite::registerOp;
+    using registers = typename InvocableWrite::registers;
+    using value_type = typename registerOp::value_type;
+
+    constexpr bool self_referenced = (
+        (register_index<std::tuple_element_t<Is, registers>, registerOp>() == 0) or ...);
+
+    detail::read_modify_write<registerOp, self_referenced>([&iw, &values](value_type old) {
+        const value_type value = iw(
+            [old, &values]<typename Source>(std::type_identity<Source>) {
+                if constexpr (register_index<Source, registerOp>() == 0) {
+                    return old;
+                } else {
+                    return Sources::template get<Source>(values);
+                }
+            }(std::type_identity<std::tuple_element_t<Is, registers>>{})
+        ...);
+        // side-effect fields passed through unchanged are written idle
+        if constexpr (self_referenced and registerOp::side_effect_mask != 0) {
+            return detail::write_back<registerOp>(value, changed_fields<registerOp>(old, value));
+        } else {
+            return value;
+        }
+    });
 }
 
+// All invocables of an apply see the registers as they were before it: every
+// source register is read once, adjacent ones in a burst. Unprotected
+// destinations are then evaluated together and written, adjacent ones in a
+// burst. Destinations protected by a concurrency policy are updated one by
+// one under it, their own value read under the policy.
 template<typename ...InvocableWrites>
 constexpr void evaluate_invocable_assignments(std::tuple<InvocableWrites...> writes) {
     constexpr bool ro_write_attempt = (InvocableWrites::type::has_ro_field or ...);
     static_assert(not ro_write_attempt, "Attemp to write read-only register");
-    evaluate_invocable_assignments_helper(writes, std::make_index_sequence<sizeof...(InvocableWrites)>{});
+
+    using sources = typename source_set_of<
+        decltype(std::tuple_cat(std::declval<typename read_phase_sources<InvocableWrites>::type>()...))>::type;
+    const auto values = sources::read();
+
+    auto unlocked = tuple_filter<is_unlocked_invocable>(writes);
+    [&]<typename... Ws, std::size_t... Is>(std::tuple<Ws...> const& batch, std::index_sequence<Is...>) {
+        if constexpr (sizeof...(Ws) > 0) {
+            auto results = std::make_tuple(evaluate_invocable<sources>(
+                std::get<Is>(batch), values,
+                std::make_index_sequence<std::tuple_size_v<typename Ws::registers>>{})...);
+            write_bursts(results);
+            (shadow_store<typename Ws::registerOp>(std::get<Is>(results).value), ...);
+        }
+    }(unlocked, std::make_index_sequence<std::tuple_size_v<decltype(unlocked)>>{});
+
+    auto locked = tuple_filter<is_locked_invocable>(writes);
+    [&]<typename... Ws, std::size_t... Is>(std::tuple<Ws...> const& one_by_one, std::index_sequence<Is...>) {
+        (evaluate_locked_invocable<sources>(
+            std::get<Is>(one_by_one), values,
+            std::make_index_sequence<std::tuple_size_v<typename Ws::registers>>{}), ...);
+    }(locked, std::make_index_sequence<std::tuple_size_v<decltype(locked)>>{});
 }
 } // namespace ros::detail
 
@@ -1046,11 +2083,14 @@ constexpr bool is_field_v = false;
 template <typename Reg, detail::msb msb, detail::lsb lsb, access_type AT, detail::field_type field_t>
 constexpr bool is_field_v<field<Reg, msb, lsb, AT, field_t>> = true;
 
+template <typename Reg, access_type AT, typename... Segments>
+constexpr bool is_field_v<disjoint_field<Reg, AT, Segments...>> = true;
+
 template <typename T>
 constexpr bool is_reg_v = false;
 
-template <typename r, typename T, typename b, detail::addr addr>
-constexpr bool is_reg_v<reg<r, T, addr, b>> = true;
+template <typename r, typename T, typename b, detail::addr addr, typename... ps>
+constexpr bool is_reg_v<reg<r, T, addr, b, ps...>> = true;
 
 template <typename... Ops>
 struct one_field_assignment_per_apply;
@@ -1119,14 +2159,159 @@ concept register_constraints =
 
 } // namespace ros::detail
 
-template<typename Op, typename ...Ops>
-requires detail::field_constraints<Op, Ops...>
-auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_filter<detail::is_field_read>(std::make_tuple(op, ops...)))> {
+// file: alias.hpp
+namespace detail {
+
+// field writes that are exact through set and clear aliases: single bits,
+// and whole plain RW fields set to all ones or all zeros. a field of any
+// other value would be written in two steps and be torn in between
+template <typename>
+struct is_alias_write : std::false_type {};
+
+template <typename Field, typename Field::value_type val>
+struct is_alias_write<field_assignment_ct<Field, val>> : std::bool_constant<
+    Field::access == access_type::RW and
+    (Field::length == 1 or
+     static_cast<typename Field::value_type_r>(val) == 0 or
+     static_cast<typename Field::value_type_r>(val) == Field::max_value)> {};
+
+template <typename Field>
+struct is_alias_write<field_assignment_rt<Field>> : std::bool_constant<
+    Field::access == access_type::RW and Field::length == 1> {};
+
+// ones go to the set alias, zeros to the clear alias, no read
+template <typename Reg, typename... Cts, typename... Rts>
+void alias_write(std::tuple<Cts...>, std::tuple<Rts...> const& rt) {
+    using value_type = typename Reg::value_type;
+    using aliases = typename Reg::alias_policy;
+
+    constexpr value_type mask = (value_type{0} | ... | Cts::type::mask) | (value_type{0} | ... | Rts::type::mask);
+    constexpr value_type set_ct = (value_type{0} | ... | Cts::type::to_reg(value_type{0}, Cts::value));
+    const value_type set = set_ct | [&rt]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return (value_type{0} | ... | std::tuple_element_t<Is, std::tuple<Rts...>>::type::to_reg(value_type{0}, std::get<Is>(rt).value));
+    }(std::index_sequence_for<Rts...>{});
+    const value_type clear = mask & ~set;
+
+    if (set != 0) {
+        Reg::bus::write(set, Reg::address::value + aliases::set);
+    }
+    if (clear != 0) {
+        Reg::bus::write(clear, Reg::address::value + aliases::clear);
+    }
+    if constexpr (Reg::is_shadowed) {
+        shadow_t<Reg>::value = (shadow_t<Reg>::value | set) & ~clear;
+    }
+}
+} // namespace ros::detail
+
+// flips all bits of the fields with one write to the toggle alias
+template <typename Field, typename... Fields>
+requires (detail::is_field_v<Field> and (std::is_same_v<typename Field::reg, typename Fields::reg> and ...))
+void toggle(Field const&, Fields const&...) {
+    using reg = typename Field::reg;
+    using value_type = typename reg::value_type;
+    static_assert(reg::alias_policy::toggle != 0, "Register has no toggle alias");
+    static_assert(Field::access == access_type::RW and ((Fields::access == access_type::RW) and ...),
+                  "Only plain RW fields can be toggled");
+
+    constexpr value_type mask = (Field::mask | ... | Fields::mask);
+    reg::bus::write(mask, reg::address::value + reg::alias_policy::toggle);
+    if constexpr (reg::is_shadowed) {
+        detail::shadow_t<reg>::value ^= mask;
+    }
+}
+
+// file: profile.hpp
+namespace detail {
+
+template <access_event E, typename Bus, typename T>
+void profile_count() {
+    if constexpr (Bus::profiled) {
+        Bus::template count<E, T>();
+    }
+}
+
+// the register of a field apply with the path it took, and each field as
+// read or written
+template <access_event E, typename Reg, typename... Ops>
+void profile(std::tuple<Ops...> const&) {
+    using bus = typename Reg::bus;
+    profile_count<E, bus, typename Reg::reg_der>();
+    (profile_count<is_field_read<Ops>::value ? access_event::read : access_event::write, bus, typename Ops::type>(), ...);
+}
+
+// registers of a register apply, the sources of invocables as read
+template <typename... Ops>
+void profile_registers(std::tuple<Ops...> const&) {
+    ([]<typename Op>(std::type_identity<Op>) {
+        using reg = typename Op::type;
+        profile_count<is_register_read<Op>::value ? access_event::read : access_event::write, typename reg::bus, typename reg::reg_der>();
+        if constexpr (is_register_assignment_invocable<Op>::value) {
+            []<typename... Rs>(std::type_identity<std::tuple<Rs...>>) {
+                (profile_count<access_event::read, typename Rs::bus, typename Rs::reg_der>(), ...);
+            }(std::type_identity<typename Op::registers>{});
+        }
+    }(std::type_identity<Ops>{}), ...);
+}
+} // namespace ros::detail
+
+// file: lanes.hpp
+namespace detail {
+
+// narrowest aligned byte or halfword of the register holding all written
+// bits. zero width if they spread over more than a halfword
+template <typename T>
+consteval unsigned lane_width(T write_mask) {
+    for (unsigned width : {8u, 16u}) {
+        const unsigned first = std::countr_zero(write_mask) / width;
+        const unsigned last = (std::bit_width(write_mask) - 1) / width;
+        if (width < std::numeric_limits<T>::digits and first == last) {
+            return width;
+        }
+    }
+    return 0;
+}
+
+// a partial write is done as one narrow write without a read when the bus
+// has byte enables and every bit of the lane that isn't written either
+// belongs to no field or only acts when written, and goes out idle
+template <typename Reg, typename Reg::value_type write_mask>
+struct lane_write {
+    using value_type = typename Reg::value_type;
+
+    static constexpr unsigned width = lane_width(write_mask);
+    static constexpr unsigned shift = width == 0 ? 0 : std::countr_zero(write_mask) / width * width;
+    static constexpr value_type lane = width == 0 ? 0 : static_cast<value_type>(((value_type{1} << width) - 1) << shift);
+    static constexpr bool enabled = Reg::bus::byte_lanes and width != 0 and (Reg::preserved_mask & lane & ~write_mask) == 0;
+
+    using type = std::conditional_t<width == 8, std::uint8_t, std::uint16_t>;
+
+    static void write(value_type value) {
+        // a locked rmw of another thread would write the lane back stale, so
+        // it's taken here too. a cas rmw sees the change and retries
+        if constexpr (std::is_same_v<typename Reg::concurrency_policy, policy::spin_lock>) {
+            register_lock_t<Reg> lock{};
+            write_lane(value);
+        } else {
+            write_lane(value);
+        }
+    }
+
+private:
+    static void write_lane(value_type value) {
+        Reg::bus::write(static_cast<type>(value >> shift), Reg::address::value + shift / 8);
+        if constexpr (Reg::is_shadowed) {
+            shadow_t<Reg>::value = (shadow_t<Reg>::value & ~lane) | (value & lane);
+        }
+    }
+};
+} // namespace ros::detail
+
+template<typename Op, typename ...Ops>
+requires detail::field_constraints<Op, Ops...>
+auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_filter<detail::is_field_read>(std::make_tuple(op, ops...)))> {
     using value_type = typename Op::type::value_type_r;
     using reg = typename Op::type::reg;
-    using bus = typename reg::bus;
-
-    constexpr value_type rmw_mask = reg::layout;
 
     auto operations = std::make_tuple(op, ops...);
 
@@ -1146,29 +2331,54 @@ auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_f
     if constexpr (write_mask != 0) {
         static_assert(not reg::has_ro_field, "Attempt to write non-writable register");
 
-        constexpr bool is_partial_write = ((rmw_mask & write_mask) != rmw_mask);
+        constexpr bool is_partial_write = ((reg::preserved_mask & write_mask) != reg::preserved_mask);
         constexpr bool has_invocable_writes = std::tuple_size_v<decltype(writes_inv)> > 0;
-
-        if constexpr (is_partial_write || has_invocable_writes) {
-            static_assert(not reg::has_wo_field, "Attempt to read non-readable register");
-            value = bus::template read<value_type>(reg::address::value);
+        constexpr bool needs_read = is_partial_write || has_invocable_writes;
+
+        // a partial write of whole bits goes through the set/clear aliases
+        // instead of a read-modify-write, whatever the concurrency policy
+        constexpr bool use_aliases = reg::alias_policy::enabled and needs_read and
+            (detail::is_alias_write<Op>::value and ... and detail::is_alias_write<Ops>::value);
+        // so does one that fills whole byte lanes, as a narrow write, as long
+        // as only written fields are read back. that one still takes the
+        // register's spin_lock
+        auto reads = detail::tuple_filter<detail::is_field_read>(operations);
+        constexpr value_type read_mask = detail::get_write_mask<value_type>(reads);
+        constexpr bool use_lanes = not use_aliases and is_partial_write and not has_invocable_writes and
+            (read_mask & ~write_mask) == 0 and detail::lane_write<reg, write_mask>::enabled;
+
+        static_assert(not needs_read or use_aliases or use_lanes or not reg::has_wo_field, "Attempt to read non-readable register");
+
+        detail::profile<needs_read and not use_aliases and not use_lanes ? access_event::rmw : access_event::write, reg>(operations);
+
+        if constexpr (use_aliases) {
+            detail::alias_write<reg>(writes_ct, writes_rt);
+        } else if constexpr (use_lanes) {
+            value = detail::write_back<reg>(value_type{0}, write_mask);
+            value = detail::get_write_value(value, write_mask_ct, writes_ct);
+            value = detail::get_write_value(value, write_mask_rt, writes_rt);
+            detail::lane_write<reg, write_mask>::write(value);
+        } else {
+            value = detail::read_modify_write<reg, needs_read>([&](value_type value) {
+                // evaluate invocables at the beginning
+                // it doesn't make much sense to evaluate it at the end because it will have 
+                // newly assigned values. this way just literals could be provided in the lambda
+                value = detail::get_invocable_write_value(value, write_mask_inv, writes_inv);
+                value = detail::write_back<reg>(value, write_mask);
+
+                // [TODO] study efficiency of bundling together all writes
+                // compile time
+                value = detail::get_write_value(value, write_mask_ct, writes_ct);
+                // runtime
+                value = detail::get_write_value(value, write_mask_rt, writes_rt);
+
+                return value;
+            });
         }
-
-        // evaluate invocables at the beginning
-        // it doesn't make much sense to evaluate it at the end because it will have 
-        // newly assigned values. this way just literals could be provided in the lambda
-        value = detail::get_invocable_write_value(value, write_mask_inv, writes_inv);
-
-        // [TODO] study efficiency of bundling together all writes
-        // compile time
-        value = detail::get_write_value(value, write_mask_ct, writes_ct);
-        // runtime
-        value = detail::get_write_value(value, write_mask_rt, writes_rt);
-
-        bus::write(value, reg::address::value);
     } else /* if (return_reads) */ {
         // implicit because if there're no writes, the only possible op is read
-        value = bus::template read<value_type>(reg::address::value);
+        detail::profile<access_event::read, reg>(operations);
+        value = detail::bus_read<reg>();
     }
 
     auto get_read_fields = [&value]<typename ...Ts>(std::tuple<Ts...> reads) /* -> ... */ {
@@ -1194,6 +2404,7 @@ auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_f
     // checks attempts to write RO fields
 
     auto operations = std::make_tuple(op, ops...);
+    detail::profile_registers(operations);
 
     // compile-time writes
     auto writes_ct = detail::tuple_filter<detail::is_register_assignment_ct>(operations);
@@ -1208,8 +2419,8 @@ auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_f
     constexpr bool has_writes_inv = std::tuple_size_v<decltype(writes_inv)> > 0; 
 
     // first, make all reads for old values
-    //   cluster adjucent reads into separate tuples
-    //   call read_bundle to each tuple
+    //   reads are sorted by address and adjacent registers are read in one
+    //   burst. values are returned in the order of the arguments
     // if there's a write and read for the same register old read
     //   value will be returned
 
@@ -1217,44 +2428,1418 @@ auto apply(Op op, Ops ...ops) -> detail::return_reads_t<decltype(detail::tuple_f
         constexpr bool wo_read_attempt = (Rs::type::has_wo_field or ...);
         static_assert(not wo_read_attempt, "Attemp to read non-readable register");
 
-        return std::make_tuple(
-            Rs::type::bus::template read<typename Rs::type::value_type> (
-                Rs::type::address::value)
-        ...);
+        auto values = detail::read_bursts<typename Rs::type...>();
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (detail::shadow_store<typename Rs::type>(std::get<Is>(values)), ...);
+        }(std::index_sequence_for<Rs...>{});
+        return values;
     };
  
+    // second, register invocables. all of them see the registers as they
+    //   were before the apply, also when another invocable of the same apply
+    //   writes one of their sources. a destination with a spin_lock or cas
+    //   policy only has its own value read again, under the policy
     if constexpr (has_writes_inv) {
         detail::evaluate_invocable_assignments(writes_inv);
     }
-    
-    // third, cluster adjacent writes into separate tuples
-    //   call write bundled for each tuple
+    
+    // third, sort compile-time and runtime writes by address and issue each run
+    //   of adjacent registers as one burst. with per-transaction overhead
+    //   dominating the bus, an init sequence over a register block becomes
+    //   a handful of bursts instead of one round trip per register
+
+    if constexpr (has_writes_ct || has_writes_rt) {
+        []<typename ...Ws>(std::tuple<Ws...> ws) -> void {
+            constexpr bool ro_write_attempt = (Ws::type::has_ro_field or ...);
+            static_assert(not ro_write_attempt, "Attemp to write non-writable register");
+
+            detail::write_bursts(ws);
+            (detail::shadow_store<typename Ws::type>(std::get<Ws>(ws).value), ...);
+        }(std::tuple_cat(writes_ct, writes_rt));
+    }
+
+    return evaluate_reads(reads);
+}
+
+// file: transaction.hpp
+namespace detail {
+
+template <typename Reg>
+struct staged_write {
+    using value_type = typename Reg::value_type;
+
+    value_type value{};
+    value_type mask{};
+};
+} // namespace ros::detail
+
+// Collects assignments to a fixed set of registers across many calls and
+// merges them per register. On commit (or at the end of the scope) every
+// touched register is written exactly once, in address order. A register
+// whose merged writes don't cover its layout is read once before the write,
+// unless the bits left out only act when written.
+template <typename... Regs>
+class transaction {
+public:
+    transaction() = default;
+    transaction(transaction const&) = delete;
+    transaction& operator=(transaction const&) = delete;
+
+    ~transaction() {
+        commit();
+    }
+
+    template <typename Op, typename... Ops>
+    requires detail::field_constraints<Op, Ops...>
+    void apply(Op op, Ops... ops) {
+        using value_type = typename Op::type::value_type_r;
+        using reg = typename Op::type::reg;
+        constexpr std::size_t idx = detail::register_index<reg, Regs...>();
+        static_assert(idx < sizeof...(Regs), "Register is not part of the transaction");
+        static_assert(not reg::has_ro_field, "Attempt to write non-writable register");
+        static_assert(not reg::has_wo_field, "Deferred partial write may need to read non-readable register");
+        static_assert(((detail::is_field_assignment_ct<Op>::value or detail::is_field_assignment_rt<Op>::value) and ... and
+                       (detail::is_field_assignment_ct<Ops>::value or detail::is_field_assignment_rt<Ops>::value)),
+                      "Only field assignments can be deferred");
+
+        auto operations = std::make_tuple(op, ops...);
+        auto writes_ct = detail::tuple_filter<detail::is_field_assignment_ct>(operations);
+        auto writes_rt = detail::tuple_filter<detail::is_field_assignment_rt>(operations);
+
+        constexpr value_type write_mask_ct = detail::get_write_mask<value_type>(writes_ct);
+        constexpr value_type write_mask_rt = detail::get_write_mask<value_type>(writes_rt);
+
+        auto& staged = std::get<idx>(staged_);
+        staged.value = detail::get_write_value(staged.value, write_mask_ct, writes_ct);
+        staged.value = detail::get_write_value(staged.value, write_mask_rt, writes_rt);
+        staged.mask |= write_mask_ct | write_mask_rt;
+    }
+
+    template <typename Op, typename... Ops>
+    requires detail::register_constraints<Op, Ops...>
+    void apply(Op op, Ops... ops) {
+        static_assert(((detail::is_register_assignment_ct<Op>::value or detail::is_register_assignment_rt<Op>::value) and ... and
+                       (detail::is_register_assignment_ct<Ops>::value or detail::is_register_assignment_rt<Ops>::value)),
+                      "Only register assignments can be deferred");
+
+        (stage_register(op), ..., stage_register(ops));
+    }
+
+    void commit() {
+        using plan = detail::burst_plan<Regs...>;
+        [this]<std::size_t... Ks>(std::index_sequence<Ks...>) {
+            (commit_register<plan::order[Ks]>(), ...);
+        }(std::index_sequence_for<Regs...>{});
+    }
+
+private:
+    template <typename W>
+    void stage_register(W const& w) {
+        using reg = typename W::type;
+        constexpr std::size_t idx = detail::register_index<reg, Regs...>();
+        static_assert(idx < sizeof...(Regs), "Register is not part of the transaction");
+        static_assert(not reg::has_ro_field, "Attempt to write non-writable register");
+
+        // whole register assignment overrides whatever was staged before
+        std::get<idx>(staged_) = {w.value, static_cast<typename reg::value_type>(~typename reg::value_type{0})};
+    }
+
+    template <std::size_t I>
+    void commit_register() {
+        using reg = std::tuple_element_t<I, std::tuple<Regs...>>;
+        auto& staged = std::get<I>(staged_);
+
+        if (staged.mask == 0) {
+            return;
+        }
+
+        // same concurrency protection as apply: locked, or retried on cas
+        using value_type = typename reg::value_type;
+        const value_type value = staged.value;
+        const value_type mask = staged.mask;
+        if ((reg::preserved_mask & mask) != reg::preserved_mask) {
+            detail::read_modify_write<reg, true>([value, mask](value_type old) {
+                return (detail::write_back<reg>(old, mask) & ~mask) | (value & mask);
+            });
+        } else {
+            detail::read_modify_write<reg, false>([value, mask](value_type) {
+                return detail::write_back<reg>(value, mask);
+            });
+        }
+        staged = {};
+    }
+
+    std::tuple<detail::staged_write<Regs>...> staged_{};
+};
+
+// file: chain.hpp
+
+// Holds the value of one register across several apply steps, e.g. read,
+// decide, update in an interrupt handler. The register is read once when
+// the chain is created (not at all if its shadow is valid) and written once
+// on commit or at the end of the scope, if any step assigned a field.
+// Ordering:
+//  - steps run on the held value in program order, a step sees the writes
+//    of every earlier step. within a step reads return the value after the
+//    step's writes, like apply
+//  - nothing reaches the bus before the commit, so the hardware never sees
+//    intermediate values
+//  - bits the hardware changes between the read and the commit are
+//    overwritten, except side-effect bits no step assigned, which go out
+//    with their idle value
+// A spin_lock register stays locked for the lifetime of the chain. cas
+// registers can't be chained, the steps couldn't be retried.
+template <typename Reg>
+class chain {
+public:
+    using value_type = typename Reg::value_type;
+
+    static_assert(not Reg::has_wo_field, "Attempt to read non-readable register");
+    static_assert(not std::is_same_v<typename Reg::concurrency_policy, policy::cas>,
+                  "Lock-free registers can't hold their value across steps");
+
+    chain() : value_{detail::rmw_read<Reg>()} {}
+    chain(chain const&) = delete;
+    chain& operator=(chain const&) = delete;
+
+    ~chain() {
+        commit();
+    }
+
+    template <typename Op, typename... Ops>
+    requires detail::field_constraints<Op, Ops...> and std::is_same_v<typename Op::type::reg, Reg>
+    auto apply(Op op, Ops... ops) -> detail::return_reads_t<decltype(detail::tuple_filter<detail::is_field_read>(std::make_tuple(op, ops...)))> {
+        auto operations = std::make_tuple(op, ops...);
+
+        auto writes_ct = detail::tuple_filter<detail::is_field_assignment_ct>(operations);
+        auto writes_rt = detail::tuple_filter<detail::is_field_assignment_rt>(operations);
+        auto writes_inv = detail::tuple_filter<detail::is_field_assignment_invocable>(operations);
+
+        constexpr value_type write_mask_ct = detail::get_write_mask<value_type>(writes_ct);
+        constexpr value_type write_mask_rt = detail::get_write_mask<value_type>(writes_rt);
+        constexpr value_type write_mask_inv = detail::get_write_mask<value_type>(writes_inv);
+        constexpr value_type write_mask = write_mask_ct | write_mask_rt | write_mask_inv;
+
+        if constexpr (write_mask != 0) {
+            static_assert(not Reg::has_ro_field, "Attempt to write non-writable register");
+
+            // same order as apply: invocables see the value before the step
+            value_ = detail::get_invocable_write_value(value_, write_mask_inv, writes_inv);
+            value_ = detail::get_write_value(value_, write_mask_ct, writes_ct);
+            value_ = detail::get_write_value(value_, write_mask_rt, writes_rt);
+            written_ |= write_mask;
+        }
+
+        return [this]<typename... Ts>(std::tuple<Ts...>) {
+            return std::make_tuple(Ts::type::to_field(value_)...);
+        }(detail::tuple_filter<detail::is_field_read>(operations));
+    }
+
+    // writes the held value if a step assigned a field since the last commit
+    void commit() {
+        if (written_ != 0) {
+            detail::bus_write<Reg>(detail::write_back<Reg>(value_, written_));
+            written_ = 0;
+        }
+    }
+
+    value_type value() const {
+        return value_;
+    }
+
+private:
+    struct unlocked {};
+    using lock_type = std::conditional_t<std::is_same_v<typename Reg::concurrency_policy, policy::spin_lock>,
+                                         detail::register_lock_t<Reg>, unlocked>;
+
+    // taken before the read, released after the last commit
+    [[no_unique_address]] lock_type lock_{};
+    value_type value_;
+    value_type written_{};
+};
+
+template <typename Reg>
+requires std::is_same_v<typename Reg::reg_der, Reg>
+auto apply_chain(Reg const&) -> chain<Reg> {
+    return chain<Reg>{};
+}
+
+// file: sequence.hpp
+
+// one step of a register table: keep selects the bits read back from the
+// register, zero for a plain write
+template <typename T>
+struct table_write {
+    std::size_t address;
+    T value;
+    T keep;
+};
+
+namespace detail {
+template <typename Op>
+struct sequence_op;
+
+template <typename Field, typename Field::value_type val>
+struct sequence_op<field_assignment_ct<Field, val>> {
+    using reg = typename Field::reg;
+    static constexpr typename reg::value_type mask = Field::mask;
+    static constexpr typename reg::value_type value = Field::to_reg(0, val);
+};
+
+template <typename Register, typename Register::value_type val>
+struct sequence_op<register_assignment_ct<Register, val>> {
+    using reg = Register;
+    static constexpr typename reg::value_type mask = ~typename reg::value_type{0};
+    static constexpr typename reg::value_type value = val;
+};
+
+// operations passed as template arguments are const
+template <auto Op>
+using sequence_op_t = sequence_op<std::remove_cv_t<decltype(Op)>>;
+
+template <typename Bus, typename T>
+concept table_bus = requires(std::span<table_write<T> const> table) {
+    Bus::write_table(table);
+};
+} // namespace ros::detail
+
+// Register programming script made of compile-time assignments only, e.g.
+// sequence<r0.field0 = 0x1_f, r0.field1 = 0x2_f, r1.self = 0x5_r>::run().
+// The script is folded into a constant table during compilation:
+// consecutive assignments to one register become a single entry, other
+// than that program order is kept. run() replays the table in one loop, or
+// hands it to Bus::write_table in one go when the bus has a bulk writer and
+// no entry needs a read. Registers of a sequence share one bus and width.
+template <auto... Ops>
+class sequence {
+    using ops = std::tuple<detail::sequence_op_t<Ops>...>;
+    using first = typename std::tuple_element_t<0, ops>::reg;
+
+public:
+    using bus = typename first::bus;
+    using value_type = typename first::value_type;
+
+    static_assert((std::is_same_v<typename detail::sequence_op_t<Ops>::reg::bus, bus> and ...),
+                  "Registers of a sequence must share one bus");
+    static_assert((std::is_same_v<typename detail::sequence_op_t<Ops>::reg::value_type, value_type> and ...),
+                  "Registers of a sequence must have the same width");
+    static_assert(not (detail::sequence_op_t<Ops>::reg::has_ro_field or ...),
+                  "Attempt to write non-writable register");
+
+private:
+    static constexpr std::array<std::size_t, sizeof...(Ops)> addresses{detail::sequence_op_t<Ops>::reg::address::value...};
+    static constexpr std::array<value_type, sizeof...(Ops)> masks{detail::sequence_op_t<Ops>::mask...};
+    static constexpr std::array<value_type, sizeof...(Ops)> values{detail::sequence_op_t<Ops>::value...};
+    static constexpr std::array<value_type, sizeof...(Ops)> preserved{detail::sequence_op_t<Ops>::reg::preserved_mask...};
+    static constexpr std::array<value_type, sizeof...(Ops)> side_effects{detail::sequence_op_t<Ops>::reg::side_effect_mask...};
+    static constexpr std::array<value_type, sizeof...(Ops)> idle{detail::sequence_op_t<Ops>::reg::idle_value...};
+    static constexpr std::array<bool, sizeof...(Ops)> write_only{detail::sequence_op_t<Ops>::reg::has_wo_field...};
+
+    static consteval std::size_t entries() {
+        std::size_t n = 1;
+        for (std::size_t i = 1; i < sizeof...(Ops); ++i) {
+            n += addresses[i] != addresses[i - 1];
+        }
+        return n;
+    }
+
+    // merged writes of each entry, with untouched side-effect bits idle
+    static consteval auto build() -> std::array<table_write<value_type>, entries()> {
+        std::array<table_write<value_type>, entries()> t{};
+        std::size_t e = 0;
+        value_type written = 0;
+        for (std::size_t i = 0; i < sizeof...(Ops); ++i) {
+            if (i > 0 and addresses[i] != addresses[i - 1]) {
+                ++e;
+                written = 0;
+            }
+            written |= masks[i];
+            const value_type unwritten_idle = side_effects[i] & ~written;
+            t[e].address = addresses[i];
+            t[e].value = (((t[e].value & ~masks[i]) | values[i]) & ~unwritten_idle) | (idle[i] & unwritten_idle);
+            t[e].keep = preserved[i] & ~written;
+        }
+        return t;
+    }
+
+    template <table_write<value_type> W>
+    static void replay() {
+        if constexpr (W.keep != 0) {
+            bus::write((bus::template read<value_type>(W.address) & W.keep) | W.value, W.address);
+        } else {
+            bus::write(W.value, W.address);
+        }
+    }
+
+    static consteval bool reads_write_only() {
+        std::size_t e = 0;
+        for (std::size_t i = 0; i < sizeof...(Ops); ++i) {
+            if (i > 0 and addresses[i] != addresses[i - 1]) {
+                ++e;
+            }
+            if (write_only[i] and table[e].keep != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    static constexpr std::array<table_write<value_type>, entries()> table = build();
+
+    static constexpr bool needs_read = []() {
+        for (auto const& w : table) {
+            if (w.keep != 0) {
+                return true;
+            }
+        }
+        return false;
+    }();
+
+    static void run() {
+        static_assert(not reads_write_only(), "Attempt to read non-readable register");
+
+        if constexpr (not needs_read and detail::table_bus<bus, value_type>) {
+            bus::write_table(std::span<table_write<value_type> const>{table});
+        } else {
+            // unrolled, so that every entry is a store of immediates
+            [&]<std::size_t... E>(std::index_sequence<E...>) {
+                (replay<table[E]>(), ...);
+            }(std::make_index_sequence<table.size()>{});
+        }
+        // the table doesn't track types, shadowed registers read back once
+        ([]<typename Reg>(std::type_identity<Reg>) {
+            if constexpr (Reg::is_shadowed) {
+                detail::shadow_t<Reg>::valid = false;
+            }
+        }(std::type_identity<typename detail::sequence_op_t<Ops>::reg>{}), ...);
+    }
+};
+
+// file: batch.hpp
+namespace detail {
+
+template <typename Reg>
+using fields_t = decltype(reflect::to_tuple(std::declval<Reg const&>()));
+
+template <typename Fields>
+struct columns;
+
+template <typename... Fields>
+struct columns<std::tuple<Fields...>> {
+    using type = std::tuple<std::vector<typename Fields::value_type>...>;
+};
+
+// samples are processed in blocks that stay in L1 while every field column
+// is decoded
+constexpr std::size_t batch_block_bytes = 4096;
+
+// the shift-and-mask loop runs over fixed-size local lanes, which can't alias
+// the caller's buffers, so it's turned into SIMD code already at -O2
+constexpr std::size_t batch_lanes = 16;
+
+template <typename Field>
+void decode_column(typename Field::value_type_r const* samples, typename Field::value_type* column, std::size_t begin, std::size_t end) {
+    using value_type_r = typename Field::value_type_r;
+    using value_type = typename Field::value_type;
+
+    std::size_t i = begin;
+    for (; i + batch_lanes <= end; i += batch_lanes) {
+        value_type_r in[batch_lanes];
+        value_type out[batch_lanes];
+        std::memcpy(in, samples + i, sizeof(in));
+        for (std::size_t k = 0; k < batch_lanes; ++k) {
+            out[k] = Field::to_field(in[k]);
+        }
+        std::memcpy(column + i, out, sizeof(out));
+    }
+    for (; i < end; ++i) {
+        column[i] = Field::to_field(samples[i]);
+    }
+}
+
+// ors the field bits of one lane block into images and flags values out of range
+template <typename Field>
+void encode_lanes(typename Field::value_type const* column, typename Field::value_type_r (&images)[batch_lanes], typename Field::value_type_r& out_of_range) {
+    using value_type_r = typename Field::value_type_r;
+    using value_type = typename Field::value_type;
+
+    value_type in[batch_lanes];
+    std::memcpy(in, column, sizeof(in));
+    for (std::size_t k = 0; k < batch_lanes; ++k) {
+        out_of_range |= static_cast<value_type_r>(static_cast<value_type_r>(in[k]) > Field::max_value);
+        images[k] |= Field::to_reg(value_type_r{0}, in[k]);
+    }
+}
+} // namespace ros::detail
+
+// one array per field of Reg, in declaration order
+template <typename Reg>
+using columns_t = typename detail::columns<detail::fields_t<Reg>>::type;
+
+// decodes every field of every register sample into columns, reusing
+// their storage
+template <typename Reg>
+void decode_batch(std::span<typename Reg::value_type const> samples, columns_t<Reg>& columns) {
+    using fields = detail::fields_t<Reg>;
+    constexpr std::size_t block = detail::batch_block_bytes / sizeof(typename Reg::value_type);
+
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        (std::get<Is>(columns).resize(samples.size()), ...);
+
+        for (std::size_t begin = 0; begin < samples.size(); begin += block) {
+            const std::size_t end = std::min(begin + block, samples.size());
+            (detail::decode_column<std::tuple_element_t<Is, fields>>(
+                samples.data(), std::get<Is>(columns).data(), begin, end), ...);
+        }
+    }(std::make_index_sequence<std::tuple_size_v<fields>>{});
+}
+
+template <typename Reg>
+auto decode_batch(std::span<typename Reg::value_type const> samples) -> columns_t<Reg> {
+    columns_t<Reg> columns;
+    decode_batch<Reg>(samples, columns);
+    return columns;
+}
+
+// Builds register images from one contiguous column per field of Reg, in
+// declaration order, into the caller's buffer. Values are range checked in
+// the same SIMD pass. Only lane blocks holding an out-of-range value are
+// redone through runtime_check, so error handling stays the same as for
+// field assignments. Only as many images as the shortest of the buffer and
+// the columns are built, their number is returned.
+template <typename Reg, typename... Columns>
+requires (sizeof...(Columns) == std::tuple_size_v<detail::fields_t<Reg>>)
+std::size_t encode_batch(std::span<typename Reg::value_type> images, Columns const&... columns) {
+    using value_type = typename Reg::value_type;
+    using fields = detail::fields_t<Reg>;
+    constexpr std::size_t lanes = detail::batch_lanes;
+
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        auto const cols = std::make_tuple(
+            std::span<typename std::tuple_element_t<Is, fields>::value_type const>{columns}...);
+        const std::size_t count = std::min({images.size(), std::get<Is>(cols).size()...});
+
+        auto encode_one = [&cols](std::size_t i) -> value_type {
+            return (std::tuple_element_t<Is, fields>::to_reg(value_type{0},
+                        std::tuple_element_t<Is, fields>::runtime_check(std::get<Is>(cols)[i])) | ...);
+        };
+
+        std::size_t i = 0;
+        for (; i + lanes <= count; i += lanes) {
+            value_type out[lanes]{};
+            value_type out_of_range{0};
+            (detail::encode_lanes<std::tuple_element_t<Is, fields>>(
+                std::get<Is>(cols).data() + i, out, out_of_range), ...);
+
+            if (out_of_range != 0) {
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    out[k] = encode_one(i + k);
+                }
+            }
+            std::memcpy(images.data() + i, out, sizeof(out));
+        }
+        for (; i < count; ++i) {
+            images[i] = encode_one(i);
+        }
+        return count;
+    }(std::index_sequence_for<Columns...>{});
+}
+
+// as many images as the shortest column has values
+template <typename Reg, typename... Columns>
+requires (sizeof...(Columns) == std::tuple_size_v<detail::fields_t<Reg>>)
+auto encode_batch(Columns const&... columns) -> std::vector<typename Reg::value_type> {
+    std::vector<typename Reg::value_type> images(std::min({std::span{columns}.size()...}));
+    encode_batch<Reg>(std::span{images}, columns...);
+    return images;
+}
+
+// file: poll.hpp
+namespace policy {
+// what wait_until does between two polls of a register
+struct poll {};
+
+// polls back to back. lowest latency, keeps the core busy
+struct poll_spin : poll {
+    static void relax(std::size_t) {}
+};
+
+// one pause hint per poll, frees the pipeline for a sibling hyperthread and
+// saves power. plain thread yield where there is no such instruction
+struct poll_pause : poll {
+    static void relax(std::size_t) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+};
+
+// pause hints doubling with every poll up to Max, the thread yields once the
+// limit is reached. for waits that take microseconds or longer
+template <std::size_t Max = 1024>
+struct poll_backoff : poll {
+    static void relax(std::size_t polls) {
+        const std::size_t pauses = polls < std::bit_width(Max) ? std::size_t{1} << polls : Max;
+        for (std::size_t i = 0; i < pauses; ++i) {
+            poll_pause::relax(polls);
+        }
+        if (pauses >= Max) {
+            std::this_thread::yield();
+        }
+    }
+};
+} // namespace ros::policy
+
+template <typename T>
+struct wait_result {
+    T value;                           // last value read
+    bool ready;                        // predicate held before the deadline
+    std::size_t polls;
+    std::chrono::nanoseconds latency;
+
+    explicit operator bool() const { return ready; }
+};
+
+// poll statistics of a register, shared by all its fields. latency[i] counts
+// waits that took [2^(i-1), 2^i) ns
+template <typename Reg>
+struct poll_stats {
+    static inline std::array<std::atomic<std::uint64_t>, 64> latency{};
+    static inline std::atomic<std::uint64_t> waits{0};
+    static inline std::atomic<std::uint64_t> timeouts{0};
+    static inline std::atomic<std::uint64_t> polls{0};
+
+    static void record(std::size_t n, std::chrono::nanoseconds elapsed, bool ready) {
+        const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed.count(), 0));
+        latency[std::bit_width(ns)].fetch_add(1, std::memory_order_relaxed);
+        polls.fetch_add(n, std::memory_order_relaxed);
+        waits.fetch_add(1, std::memory_order_relaxed);
+        if (not ready) {
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void reset() {
+        for (auto& bucket : latency) bucket = 0;
+        waits = timeouts = polls = 0;
+    }
+};
+
+// Reads the register of field until pred(field value) holds or the deadline
+// passes. Every poll is a single bus read, no operation tuple is built. The
+// predicate is checked at least once, even with a deadline in the past.
+template <typename Field, typename Pred, typename Clock, typename Duration, typename Policy = policy::poll_backoff<>>
+requires (detail::is_field_v<Field> && 
+          std::predicate<Pred&, typename Field::value_type> && 
+          std::derived_from<Policy, policy::poll>)
+auto wait_until(Field const&, Pred pred, std::chrono::time_point<Clock, Duration> deadline, Policy = {}) 
+    -> wait_result<typename Field::value_type> {
+    using reg = typename Field::reg;
+    using value_type_r = typename Field::value_type_r;
+    static_assert((
+        static_cast<value_type_r>(Field::access) & 
+        static_cast<value_type_r>(access_type::R)) != 0, 
+        "Cannot read non-readable field");
+
+    const auto start = Clock::now();
+    std::size_t polls = 0;
+    for (;;) {
+        const auto value = Field::to_field(detail::bus_read<reg>());
+        ++polls;
+
+        const bool ready = pred(value);
+        const auto now = Clock::now();
+        if (ready or now >= deadline) {
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+            poll_stats<reg>::record(polls, latency, ready);
+            return {value, ready, polls, latency};
+        }
+        Policy::relax(polls);
+    }
+}
+
+// file: index.hpp
+namespace detail {
+
+// the only pass over the characters of a name, eight at a time. words are
+// assembled byte by byte during constant evaluation, loaded on little endian
+// targets otherwise
+constexpr std::uint64_t name_hash(std::string_view name) {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull ^ name.size();
+    for (std::size_t i = 0; i < name.size(); i += 8) {
+        std::uint64_t word = 0;
+        if (std::endian::native == std::endian::little and not std::is_constant_evaluated() and i + 8 <= name.size()) {
+            std::memcpy(&word, name.data() + i, 8);
+        } else {
+            for (std::size_t k = 0; k < 8 and i + k < name.size(); ++k) {
+                word |= std::uint64_t{static_cast<unsigned char>(name[i + k])} << (8 * k);
+            }
+        }
+        h = (h ^ word) * 0xff51afd7ed558ccdull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+// one of a family of hash functions picked by seed, applied to the name hash
+constexpr std::uint64_t seeded_hash(std::uint64_t h, std::uint32_t seed) {
+    h ^= seed * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+    return h ^ (h >> 33);
+}
+
+template <typename T>
+std::uint64_t index_read() {
+    if constexpr (is_field_v<T>) {
+        return static_cast<std::uint64_t>(T::to_field(bus_read<typename T::reg>()));
+    } else {
+        return static_cast<std::uint64_t>(bus_read<typename T::reg_der>());
+    }
+}
+
+// values that don't fit are reported to the error policy of the register and
+// nothing is written, anything else goes through apply as a runtime assignment
+template <typename T>
+bool index_write(std::uint64_t value) {
+    using value_type = typename T::value_type;
+    if constexpr (is_field_v<T>) {
+        if (value > T::max_value) {
+            error::report<typename T::reg>(T::mask, value);
+            return false;
+        }
+        apply(T{} = static_cast<value_type>(value));
+    } else {
+        if (value > std::numeric_limits<value_type>::max()) {
+            error::report<typename T::reg_der>(T::layout, value);
+            return false;
+        }
+        apply(T::self = static_cast<value_type>(value));
+    }
+    return true;
+}
+
+// accessors are instantiated only when the access type allows them, apply
+// rejects the others at compile time
+template <typename T, bool readable>
+constexpr auto index_reader() -> std::uint64_t (*)() {
+    if constexpr (readable) {
+        return &index_read<T>;
+    } else {
+        return nullptr;
+    }
+}
+
+template <typename T, bool writable>
+constexpr auto index_writer() -> bool (*)(std::uint64_t) {
+    if constexpr (writable) {
+        return &index_write<T>;
+    } else {
+        return nullptr;
+    }
+}
+} // namespace ros::detail
+
+// what the index knows about a register or field. read and write are null
+// when the field can't be read or written
+struct index_entry {
+    std::string_view name;
+    std::size_t address;
+    std::uint64_t mask;
+    unsigned lsb;
+    access_type access;
+    std::uint64_t (*read)();
+    bool (*write)(std::uint64_t);
+};
+
+// entry of a field, e.g. indexed<decltype(my_reg::field0)>("r0.field0"),
+// or of a whole register
+template <typename T>
+constexpr auto indexed(std::string_view name) -> index_entry {
+    if constexpr (detail::is_field_v<T>) {
+        constexpr bool readable = (static_cast<uint8_t>(T::access) & static_cast<uint8_t>(access_type::R)) != 0;
+        // apply refuses writes to registers with read-only fields, and partial
+        // writes to registers with write-only fields
+        using reg = typename T::reg;
+        constexpr bool writable = (static_cast<uint8_t>(T::access) & static_cast<uint8_t>(access_type::W)) != 0 and
+                                  not reg::has_ro_field and (T::mask == reg::layout or not reg::has_wo_field);
+        return {name, T::reg::address::value, T::mask, static_cast<unsigned>(std::countr_zero(T::mask)), T::access,
+                detail::index_reader<T, readable>(), detail::index_writer<T, writable>()};
+    } else {
+        using value_type = typename T::value_type;
+        constexpr bool readable = not T::has_wo_field;
+        constexpr bool writable = not T::has_ro_field;
+        constexpr auto access = readable ? (writable ? access_type::RW : access_type::RO)
+                                         : (writable ? access_type::WO : access_type::NA);
+        return {name, T::address::value, std::numeric_limits<value_type>::max(), 0, access,
+                detail::index_reader<T, readable>(), detail::index_writer<T, writable>()};
+    }
+}
+
+// Name -> register/field table for debug shells and scripts. Names are placed
+// with a perfect hash built at compile time (hash and displace, one seed per
+// bucket), so a lookup is one pass over the name, one seeded hash and one
+// comparison, without allocation. Duplicate names or an empty name fail the constant evaluation,
+// so does a bucket no seed can place.
+template <std::size_t N>
+class register_index {
+    static_assert(N > 0, "empty register index");
+    // at least a fifth of the slots stays free, the last buckets find a seed quickly
+    static constexpr std::size_t slots = std::bit_ceil(N + N / 4 + 1);
+    static constexpr std::uint32_t max_seed = 1 << 16;
+
+    std::array<index_entry, slots> table{};
+    std::array<std::uint32_t, slots> seeds{};
+
+    static constexpr std::size_t bucket(std::uint64_t h) {
+        return h & (slots - 1);
+    }
+
+    static constexpr std::size_t slot(std::uint64_t h, std::uint32_t seed) {
+        return detail::seeded_hash(h, seed) & (slots - 1);
+    }
+
+public:
+    constexpr explicit register_index(std::array<index_entry, N> const& entries) {
+        std::array<std::uint64_t, N> hash{};
+        std::array<std::size_t, slots> bucket_size{};
+        std::array<std::size_t, N> order{};
+        for (std::size_t i = 0; i < N; ++i) {
+            hash[i] = detail::name_hash(entries[i].name);
+            ++bucket_size[bucket(hash[i])];
+            order[i] = i;
+        }
+        // biggest buckets are placed first, while the table is still empty
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            const auto ba = bucket(hash[a]);
+            const auto bb = bucket(hash[b]);
+            return bucket_size[ba] != bucket_size[bb] ? bucket_size[ba] > bucket_size[bb] : ba < bb;
+        });
+
+        std::array<bool, slots> used{};
+        for (std::size_t begin = 0; begin < N;) {
+            const auto b = bucket(hash[order[begin]]);
+            const auto end = begin + bucket_size[b];
+
+            // equal names (or hashes) share a bucket and would never be placed
+            for (std::size_t i = begin; i < end; ++i) {
+                bool unique = not entries[order[i]].name.empty();
+                for (std::size_t j = begin; j < i; ++j) {
+                    unique = unique and hash[order[i]] != hash[order[j]];
+                }
+                if (not unique) {
+                    throw "register index names must be unique and not empty";
+                }
+            }
+
+            for (std::uint32_t seed = 1;; ++seed) {
+                if (seed > max_seed) {
+                    throw "register index: no seed found, grow the table";
+                }
+                bool fits = true;
+                for (std::size_t i = begin; i < end and fits; ++i) {
+                    const auto s = slot(hash[order[i]], seed);
+                    fits = not used[s];
+                    // same bucket landing twice on one slot
+                    for (std::size_t j = begin; j < i and fits; ++j) {
+                        fits = slot(hash[order[j]], seed) != s;
+                    }
+                }
+                if (not fits) {
+                    continue;
+                }
+                for (std::size_t i = begin; i < end; ++i) {
+                    const auto s = slot(hash[order[i]], seed);
+                    used[s] = true;
+                    table[s] = entries[order[i]];
+                }
+                seeds[b] = seed;
+                break;
+            }
+            begin = end;
+        }
+    }
+
+    constexpr auto find(std::string_view name) const -> index_entry const* {
+        const auto h = detail::name_hash(name);
+        auto const& e = table[slot(h, seeds[bucket(h)])];
+        return not e.name.empty() and e.name == name ? &e : nullptr;
+    }
+
+    static constexpr std::size_t size() { return N; }
+
+    // value of the field or register, nothing if unknown or not readable
+    auto read(std::string_view name) const -> std::optional<std::uint64_t> {
+        auto e = find(name);
+        if (e == nullptr or e->read == nullptr) {
+            return std::nullopt;
+        }
+        return e->read();
+    }
+
+    // false if unknown, not writable or out of range
+    bool write(std::string_view name, std::uint64_t value) const {
+        auto e = find(name);
+        return e != nullptr and e->write != nullptr and e->write(value);
+    }
+};
+
+// file: async.hpp
+
+// Coroutine producing a T. It starts when it is awaited, or with start() at
+// the top level, and resumes its awaiter right from its final suspend point.
+// The result stays in the frame until the task is destroyed.
+template <typename T>
+class task {
+public:
+    struct promise_type {
+        std::optional<T> value;
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+
+        struct final_awaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                return h.promise().continuation;
+            }
+            void await_resume() const noexcept {}
+        };
+
+        task get_return_object() {
+            return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        final_awaiter final_suspend() const noexcept { return {}; }
+        void return_value(T v) { value.emplace(std::move(v)); }
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    task(task&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+    task(task const&) = delete;
+    task& operator=(task const&) = delete;
+    task& operator=(task&&) = delete;
+
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation = awaiter;
+        return handle_;
+    }
+    T await_resume() { return std::move(*handle_.promise().value); }
+
+    // runs the task until its first suspension, e.g. on a bus transaction
+    void start() { handle_.resume(); }
+    bool done() const { return handle_.done(); }
+    T& result() { return *handle_.promise().value; }
+
+private:
+    explicit task(std::coroutine_handle<promise_type> h) : handle_{h} {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Bus whose transactions complete later. async_read and async_write return
+// awaitables, the awaiting coroutine is resumed when the transaction is done
+template <typename Bus, typename T>
+concept async_bus = requires(T value, std::size_t address) {
+    { Bus::template async_read<T>(address).await_resume() } -> std::same_as<T>;
+    { Bus::async_write(value, address).await_resume() } -> std::same_as<void>;
+};
+
+namespace detail {
+
+template <typename Reg>
+void check_async() {
+    static_assert(async_bus<typename Reg::bus, typename Reg::value_type>, "Register bus has no asynchronous interface");
+    // nothing can be held across a suspension, other coroutines run in between
+    static_assert(std::is_same_v<typename Reg::concurrency_policy, policy::no_lock>,
+                  "Asynchronous rmw is only available for registers without concurrency protection");
+}
+
+template <typename Reg>
+auto async_bus_read() {
+    return Reg::bus::template async_read<typename Reg::value_type>(Reg::address::value);
+}
+
+template <typename Reg>
+auto async_bus_write(typename Reg::value_type value) {
+    return Reg::bus::async_write(value, Reg::address::value);
+}
+
+// one transaction per register, in argument order
+template <std::size_t I = 0, typename... Ws>
+auto async_write_registers(std::tuple<Ws...> ws) -> task<std::tuple<>> {
+    if constexpr (I < sizeof...(Ws)) {
+        using reg = typename std::tuple_element_t<I, std::tuple<Ws...>>::type;
+        check_async<reg>();
+        co_await async_bus_write<reg>(std::get<I>(ws).value);
+        shadow_store<reg>(std::get<I>(ws).value);
+        co_await async_write_registers<I + 1>(ws);
+    }
+    co_return std::tuple<>{};
+}
+
+template <typename Reg, typename... Regs>
+auto async_read_registers() -> task<std::tuple<typename Reg::value_type, typename Regs::value_type...>> {
+    check_async<Reg>();
+    static_assert(not Reg::has_wo_field, "Attemp to read non-readable register");
+    auto value = co_await async_bus_read<Reg>();
+    shadow_store<Reg>(value);
+    if constexpr (sizeof...(Regs) > 0) {
+        co_return std::tuple_cat(std::make_tuple(value), co_await async_read_registers<Regs...>());
+    } else {
+        co_return std::make_tuple(value);
+    }
+}
+} // namespace ros::detail
+
+// Same operations and results as apply, but the calling coroutine is
+// suspended on each bus transaction instead of blocking the thread, so one
+// thread keeps the rmw sequences of many registers in flight. Operations on
+// one register must not overlap, they aren't protected against each other.
+template<typename Op, typename ...Ops>
+requires detail::field_constraints<Op, Ops...>
+auto apply_async(Op op, Ops ...ops) -> task<detail::return_reads_t<decltype(detail::tuple_filter<detail::is_field_read>(std::make_tuple(op, ops...)))>> {
+    using value_type = typename Op::type::value_type_r;
+    using reg = typename Op::type::reg;
+    detail::check_async<reg>();
+
+    auto operations = std::make_tuple(op, ops...);
+
+    value_type value{};
+
+    auto writes_ct = detail::tuple_filter<detail::is_field_assignment_ct>(operations);
+    auto writes_rt = detail::tuple_filter<detail::is_field_assignment_rt>(operations);
+    auto writes_inv = detail::tuple_filter<detail::is_field_assignment_invocable>(operations);
+
+    constexpr value_type write_mask_ct = detail::get_write_mask<value_type>(writes_ct);
+    constexpr value_type write_mask_rt = detail::get_write_mask<value_type>(writes_rt);
+    constexpr value_type write_mask_inv = detail::get_write_mask<value_type>(writes_inv);
+    constexpr value_type write_mask = write_mask_ct | write_mask_rt | write_mask_inv;
+
+    if constexpr (write_mask != 0) {
+        static_assert(not reg::has_ro_field, "Attempt to write non-writable register");
+
+        constexpr bool is_partial_write = ((reg::preserved_mask & write_mask) != reg::preserved_mask);
+        constexpr bool has_invocable_writes = std::tuple_size_v<decltype(writes_inv)> > 0;
+        constexpr bool needs_read = is_partial_write || has_invocable_writes;
+
+        static_assert(not needs_read or not reg::has_wo_field, "Attempt to read non-readable register");
+
+        if constexpr (needs_read) {
+            if constexpr (reg::is_shadowed) {
+                value = detail::shadow_t<reg>::valid ? detail::shadow_t<reg>::value : co_await detail::async_bus_read<reg>();
+            } else {
+                value = co_await detail::async_bus_read<reg>();
+            }
+        }
+        value = detail::get_invocable_write_value(value, write_mask_inv, writes_inv);
+        value = detail::write_back<reg>(value, write_mask);
+        value = detail::get_write_value(value, write_mask_ct, writes_ct);
+        value = detail::get_write_value(value, write_mask_rt, writes_rt);
+
+        co_await detail::async_bus_write<reg>(value);
+        detail::shadow_store<reg>(value);
+    } else {
+        value = co_await detail::async_bus_read<reg>();
+        detail::shadow_store<reg>(value);
+    }
+
+    auto get_read_fields = [&value]<typename ...Ts>(std::tuple<Ts...>) {
+        return std::make_tuple(Ts::type::to_field(value)...);
+    };
+
+    co_return get_read_fields(detail::tuple_filter<detail::is_field_read>(operations));
+}
+
+// writes go out one register at a time in argument order, reads follow them
+// like in apply. invocables aren't supported
+template<typename Op, typename ...Ops>
+requires detail::register_constraints<Op, Ops...>
+auto apply_async(Op op, Ops ...ops) -> task<detail::return_reads_t<decltype(detail::tuple_filter<detail::is_register_read>(std::make_tuple(op, ops...)))>> {
+    auto operations = std::make_tuple(op, ops...);
+
+    auto writes_ct = detail::tuple_filter<detail::is_register_assignment_ct>(operations);
+    auto writes_rt = detail::tuple_filter<detail::is_register_assignment_rt>(operations);
+    auto writes_inv = detail::tuple_filter<detail::is_register_assignment_invocable>(operations);
+    auto reads = detail::tuple_filter<detail::is_register_read>(operations);
+
+    static_assert(std::tuple_size_v<decltype(writes_inv)> == 0, "Register invocables can't be applied asynchronously");
+
+    auto writes = std::tuple_cat(writes_ct, writes_rt);
+    [&writes]<typename... Ws>(std::tuple<Ws...> const&) {
+        constexpr bool ro_write_attempt = (Ws::type::has_ro_field or ...);
+        static_assert(not ro_write_attempt, "Attemp to write non-writable register");
+    }(writes);
+    co_await detail::async_write_registers(writes);
+
+    if constexpr (std::tuple_size_v<decltype(reads)> > 0) {
+        co_return co_await [&reads]<typename... Rs>(std::tuple<Rs...> const&) {
+            return detail::async_read_registers<typename Rs::type...>();
+        }(reads);
+    } else {
+        co_return std::tuple<>{};
+    }
+}
+
+// file: recording.hpp
+
+// one bus transaction as seen by recording_bus. bursts are recorded as one
+// entry per register, a compare-exchange as the read of the value it found
+// and, when it succeeded, the write
+struct bus_record {
+    enum class kind : std::uint8_t { read, write };
+
+    std::uint64_t timestamp;           // from the stamp policy of the recorder, by default its sequence number
+    std::uint64_t address;
+    std::uint64_t value;
+    std::uint32_t width;               // bytes
+    kind op;
+    std::uint8_t reserved[3]{};        // no padding, records are copied as whole words
+};
+
+namespace policy {
+// what a recording_bus stamps its records with
+struct record_stamp {};
+
+// the transaction's number on its recorder, a load of the ring's ticket
+// counter. orders the records but says nothing about the time between them.
+// with several writers, racing transactions may get the same number
+struct stamp_sequence : record_stamp {
+    static std::uint64_t now(auto const& ring) {
+        return ring.count();
+    }
+};
+
+// cheapest monotonic counter of the target: time stamp counter on x86,
+// virtual counter on arm64
+struct stamp_ticks : record_stamp {
+    static std::uint64_t now(auto const&) {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+};
+
+// no stamp at all, records are ordered by their position only
+struct stamp_none : record_stamp {
+    static std::uint64_t now(auto const&) { return 0; }
+};
+
+// who appends to the ring of a recording_bus
+struct record_writers {};
+
+// any thread, a slot is claimed with an atomic increment and a compare-exchange
+struct multi_writer : record_writers {};
+
+// a single thread (or context) drives the bus, plain loads and stores
+struct single_writer : record_writers {};
+} // namespace ros::policy
+
+// Bus decorator keeping the last N transactions forwarded to Inner in a ring
+// allocated up front, see detail::seq_ring. The default, a single writer
+// stamping records with their sequence number, adds a few stores per
+// transaction. multi_writer (an atomic increment and a compare-exchange) and
+// stamp_ticks (a time stamp counter read) cost several times more and are
+// opt-in.
+template <typename Inner, std::size_t N = 4096, typename... policies>
+struct recording_bus : bus {
+    using inner = Inner;
+    using stamp_policy = detail::select_policy_t<policy::record_stamp, policy::stamp_sequence, policies...>;
+    using writers_policy = detail::select_policy_t<policy::record_writers, policy::single_writer, policies...>;
+
+    static inline detail::seq_ring<bus_record, N, std::is_same_v<writers_policy, policy::multi_writer>> ring{};
+
+    // transactions recorded so far, the last min(count(), N) may be in the ring
+    static std::uint64_t count() {
+        return ring.count();
+    }
+
+    // complete records oldest first, e.g. for writing them to a file
+    static auto snapshot() -> std::vector<bus_record> {
+        return ring.snapshot();
+    }
+
+    // only while the bus is idle
+    static void clear() {
+        ring.clear();
+    }
+
+    template <typename T>
+    static void record(bus_record::kind op, std::size_t address, T value) {
+        ring.push(bus_record{stamp_policy::now(ring), address, static_cast<std::uint64_t>(value), sizeof(T), op});
+    }
+
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        T value = Inner::template read<T>(address);
+        record(bus_record::kind::read, address, value);
+        return value;
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        Inner::write(val, address);
+        record(bus_record::kind::write, address, val);
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...> addrs) {
+        auto values = detail::burst_read<Inner, ValueTypes...>(addrs);
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (record(bus_record::kind::read, AdjacentAddrs::value, std::get<Is>(values)), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+        return values;
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static void write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values) {
+        detail::burst_write<Inner>(addrs, values);
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (record(bus_record::kind::write, AdjacentAddrs::value, std::get<Is>(values)), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+    }
+    template <typename T, typename Addr>
+    static bool compare_exchange(T& expected, T desired, Addr address) {
+        const T assumed = expected;
+        const bool exchanged = Inner::compare_exchange(expected, desired, address);
+        record(bus_record::kind::read, address, exchanged ? assumed : expected);
+        if (exchanged) {
+            record(bus_record::kind::write, address, desired);
+        }
+        return exchanged;
+    }
+};
+
+// Serves a recorded transaction log: every read returns the value of the next
+// record, whatever the address, so apply takes the same path it took when the
+// log was recorded. Writes are only compared with the log. A transaction that
+// doesn't match the next record (kind, address, written value) or runs past
+// the end of the log counts as a divergence, reads past the end return 0.
+struct replay_bus : bus {
+    static inline std::span<bus_record const> log{};
+    static inline std::size_t position = 0;
+    static inline std::size_t divergences = 0;
+
+    static void load(std::span<bus_record const> records) {
+        log = records;
+        position = 0;
+        divergences = 0;
+    }
+
+    static bool finished() {
+        return position == log.size();
+    }
+
+    template <typename T>
+    static T next(bus_record::kind op, std::size_t address, T value = {}) {
+        if (position == log.size()) {
+            ++divergences;
+            return T{};
+        }
+        auto const& r = log[position++];
+        const bool matches = r.op == op and r.address == address and r.width == sizeof(T) and
+                             (op == bus_record::kind::read or r.value == static_cast<std::uint64_t>(value));
+        divergences += not matches;
+        return static_cast<T>(r.value);
+    }
+
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        return next<T>(bus_record::kind::read, address);
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        next(bus_record::kind::write, address, val);
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...>) {
+        // braced initialization keeps the records in order
+        return std::tuple<ValueTypes...>{next<ValueTypes>(bus_record::kind::read, AdjacentAddrs::value)...};
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static void write(std::tuple<AdjacentAddrs...>, std::tuple<ValueTypes...> values) {
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (next(bus_record::kind::write, AdjacentAddrs::value, std::get<Is>(values)), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+    }
+    template <typename T, typename Addr>
+    static bool compare_exchange(T& expected, T desired, Addr address) {
+        const T found = next<T>(bus_record::kind::read, address);
+        // a recorded exchange may have failed spuriously, only a write right
+        // after the read tells it succeeded
+        const bool exchanged = found == expected and position < log.size() and
+                               log[position].op == bus_record::kind::write and log[position].address == address;
+        if (not exchanged) {
+            expected = found;
+            return false;
+        }
+        next(bus_record::kind::write, address, desired);
+        return true;
+    }
+};
+
+// file: profile.hpp
+namespace detail {
+
+inline std::string demangle(char const* name) {
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0) {
+        std::string out{demangled};
+        std::free(demangled);
+        return out;
+    }
+#endif
+    return name;
+}
+
+// register type name, or register name and bits for a field. fields have no
+// names of their own, reflection only knows their position
+template <typename T>
+std::string profile_name() {
+    if constexpr (is_field_v<T>) {
+        constexpr auto mask = static_cast<std::uint64_t>(T::mask);
+        constexpr unsigned lsb = std::countr_zero(mask);
+        constexpr unsigned msb = std::bit_width(mask) - 1;
+        std::string bits = ((mask >> lsb) & ((mask >> lsb) + 1)) == 0
+            ? "[" + std::to_string(msb) + ":" + std::to_string(lsb) + "]"
+            : "[mask " + std::to_string(mask) + "]";
+        return profile_name<typename T::reg>() + bits;
+    } else {
+        return demangle(typeid(T).name());
+    }
+}
+} // namespace ros::detail
+
+// Bus decorator counting what apply does with each register and field:
+// reads, writes, read-modify-writes and error reports. apply calls count
+// with the types it already has, so a hit is one increment of a counter
+// allocated per type at compile time, without any lookup. Transactions go
+// to Inner unchanged. Registers and fields are enrolled before main, the
+// ones that were hit are reported sorted by total at shutdown.
+template <typename Inner, typename... policies>
+struct profiling_bus : bus {
+    using inner = Inner;
+    using writers_policy = detail::select_policy_t<policy::record_writers, policy::multi_writer, policies...>;
+
+    static constexpr bool byte_lanes = Inner::byte_lanes;
+    static constexpr bool profiled = true;
+
+    struct counters {
+        std::array<std::atomic<std::uint64_t>, 4> hits{}; // by access_event
+        std::string (*name)();
+        counters* next;
+
+        std::uint64_t operator[](access_event e) const {
+            return hits[static_cast<std::size_t>(e)].load(std::memory_order_relaxed);
+        }
+        std::uint64_t total() const {
+            std::uint64_t sum = 0;
+            for (auto const& h : hits) {
+                sum += h.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+    };
+
+    template <access_event E, typename T>
+    static void count() {
+        static_cast<void>(enrolled<T>);
+        auto& hit = slot<T>.hits[static_cast<std::size_t>(E)];
+        if constexpr (std::is_same_v<writers_policy, policy::single_writer>) {
+            hit.store(hit.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            hit.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void report(std::ostream& out) {
+        std::vector<counters const*> hit;
+        for (auto const* c = first; c != nullptr; c = c->next) {
+            if (c->total() != 0) {
+                hit.push_back(c);
+            }
+        }
+        if (hit.empty()) {
+            return;
+        }
+        std::stable_sort(hit.begin(), hit.end(), [](auto a, auto b) { return a->total() > b->total(); });
+
+        out << std::dec << std::left << std::setw(32) << "register/field" << std::right
+            << std::setw(10) << "reads" << std::setw(10) << "writes" << std::setw(10) << "rmws" << std::setw(10) << "errors" << '\n';
+        for (auto const* c : hit) {
+            out << std::left << std::setw(32) << c->name() << std::right
+                << std::setw(10) << (*c)[access_event::read] << std::setw(10) << (*c)[access_event::write]
+                << std::setw(10) << (*c)[access_event::rmw] << std::setw(10) << (*c)[access_event::error] << '\n';
+        }
+        out << std::flush;
+    }
 
-    // writes are peformed separately. the intent is to get jem
-    //   out of compile-time accessible writes, and then let
-    //   the compiler to optimize the runtime writes
-
-    if constexpr (has_writes_ct) {
-        []<typename ...Ws>(std::tuple<Ws...>) -> void {
-            constexpr bool ro_write_attempt = (Ws::type::has_ro_field or ...);
-            static_assert(not ro_write_attempt, "Attemp to write non-writable register");
+    static void reset() {
+        for (auto* c = first; c != nullptr; c = c->next) {
+            for (auto& h : c->hits) {
+                h.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
 
-            (Ws::type::bus::write(Ws::value, Ws::type::address::value),...);
-        }(writes_ct);
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        return Inner::template read<T>(address);
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        Inner::write(val, address);
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...> addrs) {
+        return detail::burst_read<Inner, ValueTypes...>(addrs);
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static void write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values) {
+        detail::burst_write<Inner>(addrs, values);
+    }
+    template <typename T, typename Addr>
+    static bool compare_exchange(T& expected, T desired, Addr address) {
+        return Inner::compare_exchange(expected, desired, address);
     }
 
-    if constexpr (has_writes_rt) {
-        []<typename ...Ws>(std::tuple<Ws...> ws) -> void {
-            constexpr bool ro_write_attempt = (Ws::type::has_ro_field or ...);
-            static_assert(not ro_write_attempt, "Attemp to write non-writable register");
+private:
+    struct at_exit {
+        ~at_exit() {
+            report(std::cout);
+        }
+    };
 
-            (Ws::type::bus::write(std::get<Ws>(ws).value, Ws::type::address::value),...);
-        }(writes_rt);
-    }
+    static inline counters* first = nullptr;
+    static inline at_exit reporter{};
 
-    return evaluate_reads(reads);
-}
+    template <typename T>
+    static inline counters slot{{}, &detail::profile_name<T>, nullptr};
+
+    static bool enroll(counters& c) {
+        static_cast<void>(&reporter);
+        c.next = first;
+        first = &c;
+        return true;
+    }
 
+    template <typename T>
+    static inline const bool enrolled = enroll(slot<T>);
+};
 
 template <typename T, typename Reg, unsigned msb, unsigned lsb, ros::access_type AT>
 concept SafeAssignable = requires {
@@ -1291,12 +3876,32 @@ struct mmio_bus : ros::bus {
     template <typename T, typename Addr>
     static constexpr T read(Addr address) {
         std::cout << "mmio read called on addr " << std::hex << address << std::endl;
-        return T{0xfff30201};
+        return static_cast<T>(0xfff30201);
     }
     template <typename T, typename Addr>
     static constexpr void write(T val, Addr address) {
-        std::cout << "mmio write called with " << std::hex << val << " on addr " << address << std::endl;
+        std::cout << "mmio write called with " << std::hex << +val << " on addr " << address << std::endl;
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static constexpr std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...> addrs) {
+        std::cout << "mmio burst read called for " << sizeof...(ValueTypes) << " registers on addr " << std::hex << std::get<0>(addrs).value << std::endl;
+        return std::tuple<ValueTypes...>{static_cast<ValueTypes>(0xfff30201)...};
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static constexpr void write(std::tuple<AdjacentAddrs...> addrs, std::tuple<ValueTypes...> values) {
+        std::cout << "mmio burst write called with";
+        std::apply([](auto... vs) { ((std::cout << " " << std::hex << vs), ...); }, values);
+        std::cout << " on addr " << std::get<0>(addrs).value << std::endl;
     }
+    template <typename T>
+    static void write_table(std::span<ros::table_write<T> const> table) {
+        std::cout << "mmio table write of " << std::dec << table.size() << " registers from addr " << std::hex << table.front().address << std::endl;
+    }
+};
+
+// the same bus behind an interconnect with byte enables
+struct mmio_lane_bus : mmio_bus {
+    static constexpr bool byte_lanes = true;
 };
 
 using namespace ros::literals;
@@ -1311,18 +3916,1047 @@ struct my_reg : ros::reg<my_reg, uint32_t, 0x2000_addr, mmio_bus> {
     ros::field<my_reg, 12_msb, 4_lsb, ros::access_type::RW> field1;
     ros::field<my_reg, 28_msb, 12_lsb, ros::access_type::RW> field2;
     ros::field<my_reg, 31_msb, 28_lsb, ros::access_type::RW, FieldState> field3;
-    // ros::disjoint_field<my_reg, ros::access_type::RW,
-    //     ros::field_segment<2_msb, 0_lsb>,
-    //     ros::field_segment<5_msb, 4_lsb>
-    //     > dj_field;
 } r0;
 
 struct my_reg1 : ros::reg<my_reg, uint32_t, 0x3000_addr, mmio_bus> {
     ros::field<my_reg, 31_msb, 0_lsb, ros::access_type::RW> field0;
 } r1;
 
+struct my_reg2 : ros::reg<my_reg2, uint32_t, 0x3004_addr, mmio_bus> {
+    ros::field<my_reg2, 31_msb, 0_lsb, ros::access_type::RW> field0;
+} r2;
+
+struct my_reg3 : ros::reg<my_reg3, uint32_t, 0x3008_addr, mmio_bus> {
+    ros::field<my_reg3, 15_msb, 0_lsb, ros::access_type::RW> field0;
+    ros::field<my_reg3, 31_msb, 16_lsb, ros::access_type::RW> field1;
+} r3;
+
+// plain RW register, partial writes are served from the shadow copy
+struct my_reg4 : ros::reg<my_reg4, uint32_t, 0x4000_addr, mmio_bus, ros::policy::shadow_cache, ros::policy::error_ring<>> {
+    ros::field<my_reg4, 8_msb, 0_lsb, ros::access_type::RW> field0;
+    ros::field<my_reg4, 16_msb, 8_lsb, ros::access_type::RW> field1;
+    ros::field<my_reg4, 31_msb, 16_lsb, ros::access_type::RW> field2;
+} r4;
+
+struct my_reg5 : ros::reg<my_reg5, uint32_t, 0x5000_addr, mmio_bus> {
+    ros::disjoint_field<my_reg5, ros::access_type::RW,
+        ros::field_segment<2_msb, 0_lsb>,
+        ros::field_segment<5_msb, 4_lsb>
+        > dj_field;
+    ros::field<my_reg5, 4_msb, 2_lsb, ros::access_type::RW> field0;
+    ros::field<my_reg5, 31_msb, 5_lsb, ros::access_type::RW> field1;
+} r5;
+
+// 32 single-bit fields. also serves as compile-time benchmark of the
+// reflection path, e.g. time g++ -std=c++20 -fsyntax-only rmw.cpp
+struct wide_reg : ros::reg<wide_reg, uint32_t, 0x6000_addr, mmio_bus> {
+    ros::field<wide_reg, 0_msb, 0_lsb, ros::access_type::RW> bit0;
+    ros::field<wide_reg, 1_msb, 1_lsb, ros::access_type::RW> bit1;
+    ros::field<wide_reg, 2_msb, 2_lsb, ros::access_type::RW> bit2;
+    ros::field<wide_reg, 3_msb, 3_lsb, ros::access_type::RW> bit3;
+    ros::field<wide_reg, 4_msb, 4_lsb, ros::access_type::RW> bit4;
+    ros::field<wide_reg, 5_msb, 5_lsb, ros::access_type::RW> bit5;
+    ros::field<wide_reg, 6_msb, 6_lsb, ros::access_type::RW> bit6;
+    ros::field<wide_reg, 7_msb, 7_lsb, ros::access_type::RW> bit7;
+    ros::field<wide_reg, 8_msb, 8_lsb, ros::access_type::RW> bit8;
+    ros::field<wide_reg, 9_msb, 9_lsb, ros::access_type::RW> bit9;
+    ros::field<wide_reg, 10_msb, 10_lsb, ros::access_type::RW> bit10;
+    ros::field<wide_reg, 11_msb, 11_lsb, ros::access_type::RW> bit11;
+    ros::field<wide_reg, 12_msb, 12_lsb, ros::access_type::RW> bit12;
+    ros::field<wide_reg, 13_msb, 13_lsb, ros::access_type::RW> bit13;
+    ros::field<wide_reg, 14_msb, 14_lsb, ros::access_type::RW> bit14;
+    ros::field<wide_reg, 15_msb, 15_lsb, ros::access_type::RW> bit15;
+    ros::field<wide_reg, 16_msb, 16_lsb, ros::access_type::RW> bit16;
+    ros::field<wide_reg, 17_msb, 17_lsb, ros::access_type::RW> bit17;
+    ros::field<wide_reg, 18_msb, 18_lsb, ros::access_type::RW> bit18;
+    ros::field<wide_reg, 19_msb, 19_lsb, ros::access_type::RW> bit19;
+    ros::field<wide_reg, 20_msb, 20_lsb, ros::access_type::RW> bit20;
+    ros::field<wide_reg, 21_msb, 21_lsb, ros::access_type::RW> bit21;
+    ros::field<wide_reg, 22_msb, 22_lsb, ros::access_type::RW> bit22;
+    ros::field<wide_reg, 23_msb, 23_lsb, ros::access_type::RW> bit23;
+    ros::field<wide_reg, 24_msb, 24_lsb, ros::access_type::RW> bit24;
+    ros::field<wide_reg, 25_msb, 25_lsb, ros::access_type::RW> bit25;
+    ros::field<wide_reg, 26_msb, 26_lsb, ros::access_type::RW> bit26;
+    ros::field<wide_reg, 27_msb, 27_lsb, ros::access_type::RW> bit27;
+    ros::field<wide_reg, 28_msb, 28_lsb, ros::access_type::RW> bit28;
+    ros::field<wide_reg, 29_msb, 29_lsb, ros::access_type::RW> bit29;
+    ros::field<wide_reg, 30_msb, 30_lsb, ros::access_type::RW> bit30;
+    ros::field<wide_reg, 31_msb, 31_lsb, ros::access_type::RW> bit31;
+} wr;
+
+static_assert(std::tuple_size_v<decltype(ros::reflect::to_tuple(wide_reg{}))> == 32);
+static_assert(wide_reg::layout == 0xffffffff);
+static_assert(not wide_reg::has_ro_field and not wide_reg::has_wo_field);
+
+// the most fields reflect::to_tuple supports. ros-reflect-bench.sh times
+// registers of 16, 32 and 64 fields
+struct wide64_reg : ros::reg<wide64_reg, uint64_t, 0x6008_addr, mmio_bus> {
+    ros::field<wide64_reg, 0_msb, 0_lsb, ros::access_type::RW> bit0;
+    ros::field<wide64_reg, 1_msb, 1_lsb, ros::access_type::RW> bit1;
+    ros::field<wide64_reg, 2_msb, 2_lsb, ros::access_type::RW> bit2;
+    ros::field<wide64_reg, 3_msb, 3_lsb, ros::access_type::RW> bit3;
+    ros::field<wide64_reg, 4_msb, 4_lsb, ros::access_type::RW> bit4;
+    ros::field<wide64_reg, 5_msb, 5_lsb, ros::access_type::RW> bit5;
+    ros::field<wide64_reg, 6_msb, 6_lsb, ros::access_type::RW> bit6;
+    ros::field<wide64_reg, 7_msb, 7_lsb, ros::access_type::RW> bit7;
+    ros::field<wide64_reg, 8_msb, 8_lsb, ros::access_type::RW> bit8;
+    ros::field<wide64_reg, 9_msb, 9_lsb, ros::access_type::RW> bit9;
+    ros::field<wide64_reg, 10_msb, 10_lsb, ros::access_type::RW> bit10;
+    ros::field<wide64_reg, 11_msb, 11_lsb, ros::access_type::RW> bit11;
+    ros::field<wide64_reg, 12_msb, 12_lsb, ros::access_type::RW> bit12;
+    ros::field<wide64_reg, 13_msb, 13_lsb, ros::access_type::RW> bit13;
+    ros::field<wide64_reg, 14_msb, 14_lsb, ros::access_type::RW> bit14;
+    ros::field<wide64_reg, 15_msb, 15_lsb, ros::access_type::RW> bit15;
+    ros::field<wide64_reg, 16_msb, 16_lsb, ros::access_type::RW> bit16;
+    ros::field<wide64_reg, 17_msb, 17_lsb, ros::access_type::RW> bit17;
+    ros::field<wide64_reg, 18_msb, 18_lsb, ros::access_type::RW> bit18;
+    ros::field<wide64_reg, 19_msb, 19_lsb, ros::access_type::RW> bit19;
+    ros::field<wide64_reg, 20_msb, 20_lsb, ros::access_type::RW> bit20;
+    ros::field<wide64_reg, 21_msb, 21_lsb, ros::access_type::RW> bit21;
+    ros::field<wide64_reg, 22_msb, 22_lsb, ros::access_type::RW> bit22;
+    ros::field<wide64_reg, 23_msb, 23_lsb, ros::access_type::RW> bit23;
+    ros::field<wide64_reg, 24_msb, 24_lsb, ros::access_type::RW> bit24;
+    ros::field<wide64_reg, 25_msb, 25_lsb, ros::access_type::RW> bit25;
+    ros::field<wide64_reg, 26_msb, 26_lsb, ros::access_type::RW> bit26;
+    ros::field<wide64_reg, 27_msb, 27_lsb, ros::access_type::RW> bit27;
+    ros::field<wide64_reg, 28_msb, 28_lsb, ros::access_type::RW> bit28;
+    ros::field<wide64_reg, 29_msb, 29_lsb, ros::access_type::RW> bit29;
+    ros::field<wide64_reg, 30_msb, 30_lsb, ros::access_type::RW> bit30;
+    ros::field<wide64_reg, 31_msb, 31_lsb, ros::access_type::RW> bit31;
+    ros::field<wide64_reg, 32_msb, 32_lsb, ros::access_type::RW> bit32;
+    ros::field<wide64_reg, 33_msb, 33_lsb, ros::access_type::RW> bit33;
+    ros::field<wide64_reg, 34_msb, 34_lsb, ros::access_type::RW> bit34;
+    ros::field<wide64_reg, 35_msb, 35_lsb, ros::access_type::RW> bit35;
+    ros::field<wide64_reg, 36_msb, 36_lsb, ros::access_type::RW> bit36;
+    ros::field<wide64_reg, 37_msb, 37_lsb, ros::access_type::RW> bit37;
+    ros::field<wide64_reg, 38_msb, 38_lsb, ros::access_type::RW> bit38;
+    ros::field<wide64_reg, 39_msb, 39_lsb, ros::access_type::RW> bit39;
+    ros::field<wide64_reg, 40_msb, 40_lsb, ros::access_type::RW> bit40;
+    ros::field<wide64_reg, 41_msb, 41_lsb, ros::access_type::RW> bit41;
+    ros::field<wide64_reg, 42_msb, 42_lsb, ros::access_type::RW> bit42;
+    ros::field<wide64_reg, 43_msb, 43_lsb, ros::access_type::RW> bit43;
+    ros::field<wide64_reg, 44_msb, 44_lsb, ros::access_type::RW> bit44;
+    ros::field<wide64_reg, 45_msb, 45_lsb, ros::access_type::RW> bit45;
+    ros::field<wide64_reg, 46_msb, 46_lsb, ros::access_type::RW> bit46;
+    ros::field<wide64_reg, 47_msb, 47_lsb, ros::access_type::RW> bit47;
+    ros::field<wide64_reg, 48_msb, 48_lsb, ros::access_type::RW> bit48;
+    ros::field<wide64_reg, 49_msb, 49_lsb, ros::access_type::RW> bit49;
+    ros::field<wide64_reg, 50_msb, 50_lsb, ros::access_type::RW> bit50;
+    ros::field<wide64_reg, 51_msb, 51_lsb, ros::access_type::RW> bit51;
+    ros::field<wide64_reg, 52_msb, 52_lsb, ros::access_type::RW> bit52;
+    ros::field<wide64_reg, 53_msb, 53_lsb, ros::access_type::RW> bit53;
+    ros::field<wide64_reg, 54_msb, 54_lsb, ros::access_type::RW> bit54;
+    ros::field<wide64_reg, 55_msb, 55_lsb, ros::access_type::RW> bit55;
+    ros::field<wide64_reg, 56_msb, 56_lsb, ros::access_type::RW> bit56;
+    ros::field<wide64_reg, 57_msb, 57_lsb, ros::access_type::RW> bit57;
+    ros::field<wide64_reg, 58_msb, 58_lsb, ros::access_type::RW> bit58;
+    ros::field<wide64_reg, 59_msb, 59_lsb, ros::access_type::RW> bit59;
+    ros::field<wide64_reg, 60_msb, 60_lsb, ros::access_type::RW> bit60;
+    ros::field<wide64_reg, 61_msb, 61_lsb, ros::access_type::RW> bit61;
+    ros::field<wide64_reg, 62_msb, 62_lsb, ros::access_type::RW> bit62;
+    ros::field<wide64_reg, 63_msb, 63_lsb, ros::access_type::RW> bit63;
+} wr64;
+
+static_assert(std::tuple_size_v<decltype(ros::reflect::to_tuple(wide64_reg{}))> == 64);
+static_assert(wide64_reg::layout == ~0ull);
+static_assert(not wide64_reg::has_ro_field and not wide64_reg::has_wo_field);
+static_assert(decltype(wide64_reg::bit62)::mask == 1ull << 62);
+
+// gpio port with set, clear and toggle aliases
+struct gpio_reg : ros::reg<gpio_reg, uint32_t, 0x8000_addr, mmio_bus, ros::policy::alias_registers<0x4, 0x8, 0xc>> {
+    ros::field<gpio_reg, 0_msb, 0_lsb, ros::access_type::RW> led0;
+    ros::field<gpio_reg, 1_msb, 1_lsb, ros::access_type::RW> led1;
+    ros::field<gpio_reg, 15_msb, 8_lsb, ros::access_type::RW> mode;
+} gpio;
+
+// interrupt status next to its enable bits
+struct irq_reg : ros::reg<irq_reg, uint32_t, 0x7000_addr, mmio_bus> {
+    ros::field<irq_reg, 7_msb, 0_lsb, ros::access_type::RW_1C> pending;
+    ros::field<irq_reg, 15_msb, 8_lsb, ros::access_type::RW> enable;
+    ros::field<irq_reg, 16_msb, 16_lsb, ros::access_type::RW_0C> overflow;
+    ros::field<irq_reg, 31_msb, 24_lsb, ros::access_type::RW> priority;
+} ir;
+struct ctrl_reg : ros::reg<ctrl_reg, uint32_t, 0x9000_addr, mmio_lane_bus> {
+    ros::field<ctrl_reg, 8_msb, 0_lsb, ros::access_type::RW> mode;
+    ros::field<ctrl_reg, 16_msb, 8_lsb, ros::access_type::RW> threshold;
+    ros::field<ctrl_reg, 20_msb, 16_lsb, ros::access_type::RW> prescaler;
+    ros::field<ctrl_reg, 31_msb, 24_lsb, ros::access_type::RW> id;
+} ctl;
+
+// bits 20..23 hold no field, so the prescaler owns its byte lane
+static_assert(ros::detail::lane_write<ctrl_reg, decltype(ctl.prescaler)::mask>::enabled);
+static_assert(not ros::detail::lane_write<ctrl_reg, decltype(ctl.mode)::mask | decltype(ctl.id)::mask>::enabled);
+
+static_assert(irq_reg::side_effect_mask == 0x1'007f and irq_reg::idle_value == 0x1'0000);
+
+// interrupt acknowledge, nothing but write-one-to-clear bits
+struct ack_reg : ros::reg<ack_reg, uint32_t, 0x7004_addr, mmio_bus> {
+    ros::field<ack_reg, 7_msb, 0_lsb, ros::access_type::RW_1C> rx;
+    ros::field<ack_reg, 15_msb, 8_lsb, ros::access_type::RW_1C> tx;
+} ack;
+
+// registers and fields by name, as a debug shell sees them
+constexpr ros::register_index debug_index{std::array{
+    ros::indexed<my_reg>("r0"),
+    ros::indexed<decltype(my_reg::field0)>("r0.field0"),
+    ros::indexed<decltype(my_reg::field1)>("r0.field1"),
+    ros::indexed<decltype(my_reg::field2)>("r0.field2"),
+    ros::indexed<decltype(my_reg::field3)>("r0.field3"),
+    ros::indexed<my_reg4>("r4"),
+    ros::indexed<decltype(my_reg4::field0)>("r4.field0"),
+    ros::indexed<decltype(my_reg4::field1)>("r4.field1"),
+    ros::indexed<decltype(my_reg4::field2)>("r4.field2"),
+    ros::indexed<decltype(my_reg5::dj_field)>("r5.dj_field")
+}};
+static_assert(debug_index.find("r0.field1")->address == 0x2000 and debug_index.find("r0.field1")->lsb == 4);
+static_assert(debug_index.find("r0.field4") == nullptr);
+
+
+// in-memory bus with atomic accesses, stands in for a bus exposing compare-exchange
+struct atomic_bus : ros::bus {
+    static inline std::array<std::atomic<uint32_t>, 1024> memory{};
+
+    static std::atomic<uint32_t>& at(std::size_t address) {
+        return memory[(address / sizeof(uint32_t)) % memory.size()];
+    }
+
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        return at(address).load(std::memory_order_relaxed);
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        at(address).store(val, std::memory_order_relaxed);
+    }
+    template <typename T, typename Addr>
+    static bool compare_exchange(T& expected, T desired, Addr address) {
+        return at(address).compare_exchange_weak(expected, desired, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+};
+
+// the same memory behind byte enables: a narrow write changes only its own
+// bytes of the word, atomically
+struct atomic_lane_bus : atomic_bus {
+    static constexpr bool byte_lanes = true;
+
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        if constexpr (sizeof(T) == sizeof(uint32_t)) {
+            atomic_bus::write(val, address);
+        } else {
+            const unsigned shift = address % sizeof(uint32_t) * 8;
+            const uint32_t lane = ((uint32_t{1} << (8 * sizeof(T))) - 1) << shift;
+            auto& word = at(address);
+            uint32_t old = word.load(std::memory_order_relaxed);
+            while (not word.compare_exchange_weak(old, (old & ~lane) | static_cast<uint32_t>(val) << shift,
+                                                  std::memory_order_relaxed)) {
+            }
+        }
+    }
+};
+
+// Register file kept in an mmap'd page (a plain array where mmap isn't
+// available). Stores real values and counts bus transactions and bytes, so
+// the cost of apply can be measured and host-side tests run at memory speed.
+struct sim_bus : ros::bus {
+    static constexpr std::size_t size = 0x10000;
+    static constexpr bool byte_lanes = true;
+
+    static inline std::uint64_t reads = 0;
+    static inline std::uint64_t writes = 0;
+    static inline std::uint64_t bytes = 0;
+
+    // whether memory came from mmap and has to be unmapped when replaced
+    static inline bool mapped = false;
+
+    static std::byte* map_anonymous() {
+#if __has_include(<sys/mman.h>)
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            mapped = true;
+            return static_cast<std::byte*>(p);
+        }
+#endif
+        alignas(64) static std::byte fallback[size]{};
+        return fallback;
+    }
+
+    static inline std::byte* memory = map_anonymous();
+
+#if __has_include(<sys/mman.h>)
+    // backs the register file with a file, e.g. to inspect it after a run.
+    // the previous mapping is released, its contents aren't carried over
+    static bool map_file(char const* path) {
+        int fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (ftruncate(fd, size) != 0) {
+            close(fd);
+            return false;
+        }
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        if (mapped) {
+            munmap(memory, size);
+        }
+        memory = static_cast<std::byte*>(p);
+        mapped = true;
+        return true;
+    }
+#endif
+
+    static void reset_counters() {
+        reads = writes = bytes = 0;
+    }
+
+    static std::uint64_t transactions() {
+        return reads + writes;
+    }
+
+    // accesses have to be aligned to their width and inside the register
+    // file, a register map that doesn't fit is a bug of the test
+    template <typename T>
+    static std::size_t offset(std::size_t address) {
+        static_assert(std::has_single_bit(sizeof(T)) and size % sizeof(T) == 0);
+        assert(address % sizeof(T) == 0 and address + sizeof(T) <= size);
+        return address;
+    }
+
+    template <typename T, typename Addr>
+    static T load(Addr address) {
+        T val;
+        std::memcpy(&val, memory + offset<T>(address), sizeof(T));
+        return val;
+    }
+    template <typename T, typename Addr>
+    static void store(T val, Addr address) {
+        std::memcpy(memory + offset<T>(address), &val, sizeof(T));
+    }
+
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        ++reads;
+        bytes += sizeof(T);
+        return load<T>(address);
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        ++writes;
+        bytes += sizeof(T);
+        store(val, address);
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...>) {
+        ++reads;
+        bytes += (sizeof(ValueTypes) + ...);
+        return std::tuple<ValueTypes...>{load<ValueTypes>(AdjacentAddrs::value)...};
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static void write(std::tuple<AdjacentAddrs...>, std::tuple<ValueTypes...> values) {
+        ++writes;
+        bytes += (sizeof(ValueTypes) + ...);
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (store(std::get<Is>(values), AdjacentAddrs::value), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+    }
+};
+
+// sim_bus memory behind an asynchronous interface. Each transaction completes
+// latency after it was issued, on a simulated clock, and the memory is only
+// accessed at completion. run() resumes coroutines in completion order until
+// nothing is in flight, the clock jumps from one completion to the next.
+struct sim_async_bus : sim_bus {
+    static inline std::chrono::nanoseconds latency{std::chrono::microseconds{10}};
+    static inline std::chrono::nanoseconds now{0};
+    static inline std::uint64_t completed = 0;
+
+    struct completion {
+        std::chrono::nanoseconds due;
+        std::uint64_t sequence;
+        std::coroutine_handle<> waiter;
+
+        // earliest first, issue order among equal times
+        bool operator>(completion const& other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+
+    static inline std::vector<completion> in_flight;
+    static inline std::uint64_t issued = 0;
+
+    static void issue(std::coroutine_handle<> waiter) {
+        in_flight.push_back({now + latency, issued++, waiter});
+        std::push_heap(in_flight.begin(), in_flight.end(), std::greater<>{});
+    }
+
+    static void run() {
+        while (not in_flight.empty()) {
+            std::pop_heap(in_flight.begin(), in_flight.end(), std::greater<>{});
+            auto next = in_flight.back();
+            in_flight.pop_back();
+            now = next.due;
+            ++completed;
+            next.waiter.resume();
+        }
+    }
+
+    template <typename T>
+    struct read_transaction {
+        std::size_t address;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> waiter) const { issue(waiter); }
+        T await_resume() const { return read<T>(address); }
+    };
+
+    template <typename T>
+    struct write_transaction {
+        T value;
+        std::size_t address;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> waiter) const { issue(waiter); }
+        void await_resume() const { write(value, address); }
+    };
+
+    template <typename T, typename Addr>
+    static auto async_read(Addr address) -> read_transaction<T> {
+        return {address};
+    }
+    template <typename T, typename Addr>
+    static auto async_write(T val, Addr address) -> write_transaction<T> {
+        return {val, address};
+    }
+};
+
+// register map generated by ros-gen, e.g. -DROS_REGISTER_MAP='"map.hpp"'
+#if defined(ROS_REGISTER_MAP)
+#include ROS_REGISTER_MAP
+#endif
+
+template <typename Policy, std::size_t Base, std::size_t N>
+struct contended_reg : ros::reg<contended_reg<Policy, Base, N>, uint32_t, ros::detail::addr<std::size_t, Base + 4 * N>{}, atomic_bus, Policy> {
+    ros::field<contended_reg, 31_msb, 0_lsb, ros::access_type::RW> count;
+};
+
+// Every thread increments the count of either one shared register or a
+// register of its own. Lost updates show which policies are incorrect.
+template <typename Policy, std::size_t Base>
+void bench_contention(std::string_view name, bool shared) {
+    constexpr unsigned iterations = 20000;
+    constexpr std::size_t max_threads = 64;
+
+    auto worker = []<std::size_t N>(std::integral_constant<std::size_t, N>) {
+        for (unsigned i = 0; i < iterations; ++i) {
+            ros::apply(contended_reg<Policy, Base, N>{}.count([](auto count) {
+                return count + 1;
+            }));
+        }
+    };
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        for (auto& word : atomic_bus::memory) word = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        [&]<std::size_t... Ns>(std::index_sequence<Ns...>) {
+            std::array<std::thread, max_threads> pool{};
+            ((Ns < threads ? void(pool[Ns] = shared ? std::thread{worker, std::integral_constant<std::size_t, 0>{}} 
+                                                    : std::thread{worker, std::integral_constant<std::size_t, Ns>{}}) 
+                           : void()), ...);
+            for (auto& t : pool) if (t.joinable()) t.join();
+        }(std::make_index_sequence<max_threads>{});
+        auto end = std::chrono::steady_clock::now();
+
+        std::size_t counted = 0;
+        for (std::size_t n = 0; n < (shared ? 1 : threads); ++n) {
+            counted += atomic_bus::at(Base + 4 * n);
+        }
+        const std::size_t expected = threads * iterations;
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+        std::cout << name << (shared ? " shared   " : " disjoint ") << std::dec << threads << " threads: "
+                  << ns / (threads * iterations) << " ns/op, "
+                  << (counted == expected ? "no lost updates" : "lost updates") << std::endl;
+    }
+}
+
+template <typename Policy, std::size_t Address>
+struct lane_owned_reg : ros::reg<lane_owned_reg<Policy, Address>, uint32_t, ros::detail::addr<std::size_t, Address>{}, atomic_bus, Policy> {
+    ros::field<lane_owned_reg, 8_msb, 0_lsb, ros::access_type::RW> lane0;
+    ros::field<lane_owned_reg, 16_msb, 8_lsb, ros::access_type::RW> lane1;
+    ros::field<lane_owned_reg, 24_msb, 16_lsb, ros::access_type::RW> lane2;
+    ros::field<lane_owned_reg, 31_msb, 24_lsb, ros::access_type::RW> lane3;
+};
+
+// Four threads commit transactions on one register, each to a field of its
+// own. A partial commit that isn't protected overwrites the other fields
+// with stale values.
+template <typename Policy, std::size_t Address>
+void bench_transaction_contention(std::string_view name) {
+    using reg = lane_owned_reg<Policy, Address>;
+    constexpr unsigned iterations = 20000;
+    constexpr std::uint32_t last = (iterations - 1) & 0x7f;
+
+    atomic_bus::at(Address) = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        auto committer = [](auto field) {
+            for (unsigned i = 0; i < iterations; ++i) {
+                ros::transaction<reg> tx;
+                tx.apply(field = i & 0x7f);
+            }
+        };
+        std::jthread t0{committer, reg{}.lane0}, t1{committer, reg{}.lane1}, t2{committer, reg{}.lane2}, t3{committer, reg{}.lane3};
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const std::uint32_t value = atomic_bus::at(Address);
+    const bool intact = value == (last | last << 8 | last << 16 | last << 24);
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << name << " transaction 4 threads: " << ns / (4 * iterations) << " ns/op, "
+              << (intact ? "no lost updates" : "lost updates") << std::endl;
+}
+
+template <typename Policy, std::size_t Address>
+struct shared_lane_reg : ros::reg<shared_lane_reg<Policy, Address>, uint32_t, ros::detail::addr<std::size_t, Address>{}, atomic_lane_bus, Policy> {
+    ros::field<shared_lane_reg, 8_msb, 0_lsb, ros::access_type::RW> flags;
+    ros::field<shared_lane_reg, 31_msb, 8_lsb, ros::access_type::RW> count;
+};
+
+// One thread sets the flags byte with narrow lane writes, checking each time
+// that it still holds what it wrote last, while three threads increment the
+// count with read-modify-writes. A lane write landing in the middle of one of
+// those is written back stale.
+template <typename Policy, std::size_t Address>
+void bench_lane_contention(std::string_view name) {
+    using reg = shared_lane_reg<Policy, Address>;
+    static_assert(ros::detail::lane_write<reg, decltype(reg::flags)::mask>::enabled);
+    constexpr unsigned iterations = 20000;
+
+    atomic_bus::at(Address) = 0;
+    bool intact = true;
+    std::atomic<bool> done{false};
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::jthread flagger{[&intact, &done] {
+            std::uint32_t last = 0;
+            // a few writes spread over the whole run, a cas rmw retries on each
+            for (unsigned i = 0; i < iterations / 10 and not done.load(std::memory_order_relaxed); ++i) {
+                // straight from memory, a read through apply would wait for the lock
+                intact &= (atomic_bus::at(Address) & 0xff) == last;
+                last = (i + 1) & 0x7f;
+                ros::apply(reg{}.flags = last);
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            }
+        }};
+        {
+            auto counter = [] {
+                for (unsigned i = 0; i < iterations; ++i) {
+                    // yielding between read and write widens the window
+                    ros::apply(reg{}.count([](auto count) { std::this_thread::yield(); return count + 1; }));
+                }
+            };
+            std::jthread t0{counter}, t1{counter}, t2{counter};
+        }
+        done.store(true, std::memory_order_relaxed);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    intact &= atomic_bus::at(Address) >> 8 == 3 * iterations;
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << name << " lanes 4 threads: " << ns / (3 * iterations) << " ns/rmw, "
+              << (intact ? "no lost updates" : "lost updates") << std::endl;
+}
+
+// Four threads fill a small ring with records whose fields all hold the same
+// number while a reader keeps copying it. A record read while it's being
+// written would show fields of two different numbers.
+void bench_ring_contention() {
+    constexpr std::uint64_t iterations = 200000;
+    static ros::detail::seq_ring<ros::error::record, 16> ring{};
+
+    std::atomic<bool> done{false};
+    std::uint64_t copied = 0;
+    bool intact = true;
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::jthread reader{[&] {
+            while (not done.load(std::memory_order_acquire)) {
+                for (auto const& r : ring.snapshot()) {
+                    intact &= r.address == r.mask and r.mask == r.value and r.value == r.timestamp;
+                    ++copied;
+                }
+            }
+        }};
+        {
+            auto writer = [](std::uint64_t first) {
+                for (std::uint64_t i = first; i < first + iterations; ++i) {
+                    ring.push(ros::error::record{i, i, i, i});
+                }
+            };
+            std::jthread t0{writer, 0}, t1{writer, iterations}, t2{writer, 2 * iterations}, t3{writer, 3 * iterations};
+        }
+        done.store(true, std::memory_order_release);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "seq_ring  4 writers 1 reader: " << ns / (4 * iterations) << " ns/push, "
+              << copied << " records copied, " << ring.dropped() << " dropped, "
+              << (intact ? "no torn records" : "torn records") << std::endl;
+}
+
+struct sim_reg : ros::reg<sim_reg, uint32_t, 0x100_addr, sim_bus> {
+    ros::field<sim_reg, 8_msb, 0_lsb, ros::access_type::RW> field0;
+    ros::field<sim_reg, 16_msb, 8_lsb, ros::access_type::RW> field1;
+    ros::field<sim_reg, 31_msb, 16_lsb, ros::access_type::RW> field2;
+} sr;
+
+// accesses to these are counted, the report is printed at exit
+using profiled_sim_bus = ros::profiling_bus<sim_bus, ros::policy::single_writer>;
+
+struct uart_reg : ros::reg<uart_reg, uint32_t, 0x300_addr, profiled_sim_bus> {
+    ros::field<uart_reg, 8_msb, 0_lsb, ros::access_type::RW> data;
+    ros::field<uart_reg, 16_msb, 8_lsb, ros::access_type::RW> level;
+    ros::field<uart_reg, 16_msb, 16_lsb, ros::access_type::RW> enable;
+} uart;
+
+struct timer_reg : ros::reg<timer_reg, uint32_t, 0x304_addr, profiled_sim_bus> {
+    ros::field<timer_reg, 31_msb, 0_lsb, ros::access_type::RW> count;
+} timer;
+
+// firmware main loop: polls the uart level, feeds it and ticks the timer
+void uart_session(std::uint32_t t) {
+    ros::apply(uart.enable = 0x1_f, uart.level = 0x0_f);
+    for (std::uint32_t i = 0; i < 16; ++i) {
+        auto [level] = ros::apply(uart.level.read());
+        if (level < 8) {
+            ros::apply(uart.data = (i + t) & 0xff, uart.level = level + 1);
+        }
+        ros::apply(timer.count([](auto c) { return c + 1; }));
+    }
+    // out of range, clamped and reported
+    ros::apply(uart.level = t << 8);
+}
+
+template <std::size_t N>
+struct sim_block_reg : ros::reg<sim_block_reg<N>, uint32_t, ros::detail::addr<std::size_t, 0x200 + 4 * N>{}, sim_bus> {
+    ros::field<sim_block_reg, 31_msb, 0_lsb, ros::access_type::RW> field0;
+};
+
+constexpr ros::register_index sim_index{std::array{
+    ros::indexed<sim_reg>("sr"),
+    ros::indexed<decltype(sim_reg::field0)>("sr.field0"),
+    ros::indexed<decltype(sim_reg::field1)>("sr.field1"),
+    ros::indexed<decltype(sim_reg::field2)>("sr.field2")
+}};
+
+using recorder = ros::recording_bus<sim_bus, 1 << 16>;
+
+template <typename Bus>
+struct trace_reg : ros::reg<trace_reg<Bus>, uint32_t, 0x180_addr, Bus> {
+    ros::field<trace_reg, 7_msb, 0_lsb, ros::access_type::RW> field0;
+    ros::field<trace_reg, 31_msb, 8_lsb, ros::access_type::RW> field1;
+};
+
+// same bus traffic whether it runs live or against a replayed log
+template <typename Bus>
+std::uint32_t trace_session(std::uint32_t t) {
+    trace_reg<Bus> tr;
+    ros::apply(tr.field0 = t & 0xff);
+    ros::apply(tr.field1([](auto f1) { return f1 + 3; }));
+    auto [f0, f1] = ros::apply(tr.field0.read(), tr.field1.read());
+    return f0 ^ f1;
+}
+
+template <std::size_t N>
+struct async_reg : ros::reg<async_reg<N>, uint32_t, ros::detail::addr<std::size_t, 0x1000 + 4 * N>{}, sim_async_bus> {
+    ros::field<async_reg, 7_msb, 0_lsb, ros::access_type::RW> count;
+    ros::field<async_reg, 15_msb, 8_lsb, ros::access_type::RW> id;
+    ros::field<async_reg, 31_msb, 16_lsb, ros::access_type::RW> mode;
+};
+
+template <std::size_t N>
+constexpr async_reg<N> ar{};
+
+// bring-up of one peripheral, 12 bus transactions
+template <std::size_t N>
+auto bring_up() -> ros::task<std::uint32_t> {
+    co_await ros::apply_async(async_reg<N>::self = 0x0_r);
+    co_await ros::apply_async(ar<N>.id = std::uint32_t{N});
+    for (int i = 0; i < 4; ++i) {
+        co_await ros::apply_async(ar<N>.count([](auto count) { return count + 1; }));
+    }
+    auto [count, id] = co_await ros::apply_async(ar<N>.count.read(), ar<N>.id.read());
+    co_return count + id;
+}
+
+template <typename F>
+double bench_op(std::string_view name, F op) {
+    constexpr std::uint32_t iterations = 5'000'000;
+    static volatile std::uint64_t sink = 0;
+
+    sim_bus::reset_counters();
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < iterations; ++i) {
+        if constexpr (std::is_void_v<decltype(op(i))>) {
+            op(i);
+        } else {
+            sink = sink + op(i);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << name << ": " << ns / iterations << " ns/op, "
+              << static_cast<double>(sim_bus::transactions()) / iterations << " transactions/op, "
+              << static_cast<double>(sim_bus::bytes) / iterations << " bytes/op" << std::endl;
+    return ns / iterations;
+}
+
+void bench_apply() {
+    using block = std::tuple<sim_block_reg<0>, sim_block_reg<1>, sim_block_reg<2>, sim_block_reg<3>>;
+
+    bench_op("field write ct       ", [](std::uint32_t) {
+        ros::apply(sr.field0 = 0x5_f);
+    });
+    bench_op("field write rt       ", [](std::uint32_t i) {
+        ros::apply(sr.field1 = i & 0x7f);
+    });
+    bench_op("field write rt, prof ", [](std::uint32_t i) {
+        ros::apply(uart.level = i & 0x7f);
+    });
+    bench_op("full field write     ", [](std::uint32_t i) {
+        ros::apply(sr.field0 = i & 0x7f, sr.field1 = 0x3_f, sr.field2 = i & 0x7fff);
+    });
+    bench_op("invocable rmw        ", [](std::uint32_t) {
+        ros::apply(sr.field2([](auto f2) { return (f2 + 1) & 0x7fff; }));
+    });
+    bench_op("3 steps, apply       ", [](std::uint32_t) {
+        auto [f0] = ros::apply(sr.field0.read());
+        ros::apply(sr.field1 = f0 & 0x7f);
+        ros::apply(sr.field2([](auto f2) { return (f2 + 1) & 0x7fff; }));
+    });
+    bench_op("3 steps, apply_chain ", [](std::uint32_t) {
+        auto c = ros::apply_chain(sr);
+        auto [f0] = c.apply(sr.field0.read());
+        c.apply(sr.field1 = f0 & 0x7f);
+        c.apply(sr.field2([](auto f2) { return (f2 + 1) & 0x7fff; }));
+    });
+    bench_op("field read           ", [](std::uint32_t) {
+        auto [f1] = ros::apply(sr.field1.read());
+        return f1;
+    });
+    // names change every iteration, as in a scripted loop
+    static constexpr std::string_view names[] = {"sr.field0", "sr.field1", "sr.field2"};
+    bench_op("index field write    ", [](std::uint32_t i) {
+        sim_index.write(names[i % 3], i & 0x7f);
+    });
+    bench_op("index field read     ", [](std::uint32_t i) {
+        return *sim_index.read(names[i % 3]);
+    });
+    bench_op("multi-register write ", [](std::uint32_t i) {
+        ros::apply(std::tuple_element_t<0, block>::self = i,
+                   std::tuple_element_t<1, block>::self = i + 1,
+                   std::tuple_element_t<2, block>::self = i + 2,
+                   std::tuple_element_t<3, block>::self = i + 3);
+    });
+    bench_op("ct init, apply per op", [](std::uint32_t) {
+        ros::apply(std::tuple_element_t<0, block>::self = 0x1_r);
+        ros::apply(std::tuple_element_t<1, block>::self = 0x2_r);
+        ros::apply(std::tuple_element_t<2, block>::self = 0x3_r);
+        ros::apply(std::tuple_element_t<3, block>::self = 0x4_r);
+    });
+    bench_op("ct init, sequence    ", [](std::uint32_t) {
+        ros::sequence<std::tuple_element_t<0, block>::self = 0x1_r,
+                      std::tuple_element_t<1, block>::self = 0x2_r,
+                      std::tuple_element_t<2, block>::self = 0x3_r,
+                      std::tuple_element_t<3, block>::self = 0x4_r>::run();
+    });
+    bench_op("multi-reg invocables ", [](std::uint32_t) {
+        using r0 = std::tuple_element_t<0, block>;
+        using r1 = std::tuple_element_t<1, block>;
+        using r2 = std::tuple_element_t<2, block>;
+        using r3 = std::tuple_element_t<3, block>;
+        ros::apply(r0::self([](auto a, auto b) { return a + b; }, r2::self, r3::self),
+                   r1::self([](auto a, auto b) { return a ^ b; }, r2::self, r3::self));
+    });
+}
+
+void bench_recording() {
+    const double plain = bench_op("rmw                  ", [](std::uint32_t) {
+        ros::apply(sr.field2([](auto f2) { return (f2 + 1) & 0x7fff; }));
+    });
+    auto recorded = [plain]<typename Bus>(std::string_view name, std::type_identity<Bus>) {
+        const double ns = bench_op(name, [](std::uint32_t) {
+            ros::apply(trace_reg<Bus>{}.field1([](auto f1) { return (f1 + 1) & 0x7fff; }));
+        });
+        // two transactions per rmw
+        std::cout << "  overhead           : " << (ns - plain) / 2 << " ns/transaction" << std::endl;
+    };
+    recorded("recorded rmw         ", std::type_identity<recorder>{});
+    recorded("recorded, stamped    ", std::type_identity<ros::recording_bus<sim_bus, 1 << 16, ros::policy::stamp_ticks>>{});
+    recorded("recorded, any writer ", std::type_identity<ros::recording_bus<sim_bus, 1 << 16, ros::policy::multi_writer>>{});
+    recorded("recorded, any stamped",
+             std::type_identity<ros::recording_bus<sim_bus, 1 << 16, ros::policy::multi_writer, ros::policy::stamp_ticks>>{});
+}
+
+// Codegen checks: each apply pattern next to the mask-and-shift code it is
+// meant to compile to, on a register file of volatile words so every access
+// stays a real load or store. ros-codegen-check.sh compares the instruction
+// counts of the pairs, --codegen their timings.
+struct mem_bus : ros::bus {
+    static inline volatile std::uint32_t words[64]{};
+
+    template <typename T, typename Addr>
+    static T read(Addr address) {
+        return words[address / 4 % 64];
+    }
+    template <typename T, typename Addr>
+    static void write(T val, Addr address) {
+        words[address / 4 % 64] = val;
+    }
+    template <typename... ValueTypes, typename... AdjacentAddrs>
+    static std::tuple<ValueTypes...> read(std::tuple<AdjacentAddrs...>) {
+        return std::tuple<ValueTypes...>{read<ValueTypes>(AdjacentAddrs::value)...};
+    }
+    template <typename... AdjacentAddrs, typename... ValueTypes>
+    static void write(std::tuple<AdjacentAddrs...>, std::tuple<ValueTypes...> values) {
+        [&values]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (write(std::get<Is>(values), AdjacentAddrs::value), ...);
+        }(std::index_sequence_for<ValueTypes...>{});
+    }
+};
+
+template <std::size_t N>
+struct cg_reg : ros::reg<cg_reg<N>, uint32_t, ros::detail::addr<std::size_t, 0x10 + 4 * N>{}, mem_bus, ros::policy::error_silent> {
+    ros::field<cg_reg, 4_msb, 0_lsb, ros::access_type::RW> field0;     // bits 0..3
+    ros::field<cg_reg, 16_msb, 4_lsb, ros::access_type::RW> field1;    // bits 4..15
+    ros::field<cg_reg, 24_msb, 16_lsb, ros::access_type::RW> field2;   // bits 16..23
+    ros::field<cg_reg, 31_msb, 24_lsb, ros::access_type::RW> field3;   // bits 24..31
+};
+
+template <std::size_t N>
+constexpr cg_reg<N> cg{};
+
+// words[4] and words[5] are cg_reg<0> and cg_reg<1>
+extern "C" {
+[[gnu::noinline]] void ros_ct_write() {
+    ros::apply(cg<0>.field0 = 0x5_f);
+}
+[[gnu::noinline]] void hand_ct_write() {
+    mem_bus::words[4] = (mem_bus::words[4] & ~0xfu) | 0x5u;
+}
+
+[[gnu::noinline]] void ros_rt_write(std::uint32_t v) {
+    ros::apply(cg<0>.field1.unsafe = v);
+}
+[[gnu::noinline]] void hand_rt_write(std::uint32_t v) {
+    mem_bus::words[4] = (mem_bus::words[4] & ~0xfff0u) | ((v << 4) & 0xfff0u);
+}
+
+[[gnu::noinline]] void ros_rt_checked_write(std::uint32_t v) {
+    ros::apply(cg<0>.field1 = v);
+}
+[[gnu::noinline]] void hand_rt_checked_write(std::uint32_t v) {
+    v = v > 0xfffu ? 0xfffu : v;
+    mem_bus::words[4] = (mem_bus::words[4] & ~0xfff0u) | ((v << 4) & 0xfff0u);
+}
+
+[[gnu::noinline]] void ros_invocable() {
+    ros::apply(cg<0>.field2([](auto f2) { return f2 + 1; }));
+}
+[[gnu::noinline]] void hand_invocable() {
+    const std::uint32_t w = mem_bus::words[4];
+    std::uint32_t f2 = ((w & 0xff0000u) >> 16) + 1;
+    f2 = f2 > 0xffu ? 0xffu : f2;
+    mem_bus::words[4] = (w & ~0xff0000u) | ((f2 << 16) & 0xff0000u);
+}
+
+[[gnu::noinline]] std::uint32_t ros_field_read() {
+    auto [f1] = ros::apply(cg<0>.field1.read());
+    return f1;
+}
+[[gnu::noinline]] std::uint32_t hand_field_read() {
+    return (mem_bus::words[4] & 0xfff0u) >> 4;
+}
+
+[[gnu::noinline]] void ros_multi_reg(std::uint32_t a, std::uint32_t b) {
+    ros::apply(cg_reg<0>::self = a, cg_reg<1>::self = b);
+}
+[[gnu::noinline]] void hand_multi_reg(std::uint32_t a, std::uint32_t b) {
+    mem_bus::words[4] = a;
+    mem_bus::words[5] = b;
+}
+}
+
+template <typename F>
+double bench_pair_side(F op) {
+    constexpr std::uint32_t iterations = 20'000'000;
+    static volatile std::uint64_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < iterations; ++i) {
+        if constexpr (std::is_void_v<decltype(op(i))>) {
+            op(i);
+        } else {
+            sink = sink + op(i);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Google Benchmark style lines, one pair per pattern
+template <typename Ros, typename Hand>
+void bench_pair(std::string_view name, Ros ros_op, Hand hand_op) {
+    const double ros_ns = bench_pair_side(ros_op);
+    const double hand_ns = bench_pair_side(hand_op);
+    for (auto [side, ns] : {std::pair{"ros", ros_ns}, std::pair{"hand", hand_ns}}) {
+        const std::string label = "BM_" + std::string{name} + "/" + side;
+        std::cout << label << std::string(label.size() < 28 ? 28 - label.size() : 1, ' ') << ns << " ns" << std::endl;
+    }
+}
+
+void bench_codegen() {
+    bench_pair("ct_write", [](std::uint32_t) { ros_ct_write(); }, [](std::uint32_t) { hand_ct_write(); });
+    bench_pair("rt_write", ros_rt_write, hand_rt_write);
+    bench_pair("rt_checked_write", ros_rt_checked_write, hand_rt_checked_write);
+    bench_pair("invocable", [](std::uint32_t) { ros_invocable(); }, [](std::uint32_t) { hand_invocable(); });
+    bench_pair("field_read", [](std::uint32_t) { return ros_field_read(); }, [](std::uint32_t) { return hand_field_read(); });
+    bench_pair("multi_reg", [](std::uint32_t i) { ros_multi_reg(i, i + 1); }, [](std::uint32_t i) { hand_multi_reg(i, i + 1); });
+}
+
+void bench_decode() {
+    constexpr std::size_t samples = 1 << 24;
+    constexpr int rounds = 8;
+
+    std::vector<uint32_t> dump(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        dump[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+
+    ros::columns_t<sim_reg> columns;
+    ros::decode_batch<sim_reg>(dump, columns);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        ros::decode_batch<sim_reg>(dump, columns);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // sample in, one value per field out
+    const std::size_t bytes_per_sample = std::apply([](auto const&... column) {
+        return sizeof(uint32_t) + (sizeof(column[0]) + ...);
+    }, columns);
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "decode batch         : " << ns / (rounds * samples) << " ns/sample, "
+              << static_cast<double>(rounds * samples * bytes_per_sample) / ns << " GB/s moved" << std::endl;
+}
+
+void bench_encode() {
+    constexpr std::size_t entries = 1 << 24;
+    constexpr int rounds = 8;
+
+    std::vector<uint32_t> f0(entries), f1(entries), f2(entries);
+    for (std::size_t i = 0; i < entries; ++i) {
+        f0[i] = i & 0xff;
+        f1[i] = (i >> 8) & 0xff;
+        f2[i] = (i >> 16) & 0xffff;
+    }
+
+    std::vector<uint32_t> table(entries);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        ros::encode_batch<sim_reg>(std::span{table}, f0, f1, f2);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // decoding the table has to give back the columns
+    auto [d0, d1, d2] = ros::decode_batch<sim_reg>(table);
+    const bool round_trip = d0 == f0 and d1 == f1 and d2 == f2;
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << "encode batch         : " << ns / (rounds * entries) << " ns/entry, "
+              << static_cast<double>(rounds * entries * 4 * sizeof(uint32_t)) / ns << " GB/s moved, "
+              << (round_trip ? "round trip ok" : "round trip failed") << std::endl;
+}
+
+template <std::size_t N>
+struct ready_reg : ros::reg<ready_reg<N>, uint32_t, ros::detail::addr<std::size_t, 0xc00 + 4 * N>{}, atomic_bus> {
+    ros::field<ready_reg, 0_msb, 0_lsb, ros::access_type::RO> ready;
+};
+
+// a second thread raises the ready bit some time after the wait started
+template <std::size_t N, typename Policy>
+void bench_wait(std::string_view name) {
+    constexpr unsigned waits = 200;
+    constexpr auto raise_after = std::chrono::microseconds{50};
+
+    using stats = ros::poll_stats<ready_reg<N>>;
+    stats::reset();
+    for (unsigned i = 0; i < waits; ++i) {
+        atomic_bus::write(uint32_t{0}, ready_reg<N>::address::value);
+        std::thread device{[raise_after] {
+            std::this_thread::sleep_for(raise_after);
+            atomic_bus::write(uint32_t{1}, ready_reg<N>::address::value);
+        }};
+        ros::wait_until(ready_reg<N>{}.ready, [](auto ready) { return ready == 1; },
+                        std::chrono::steady_clock::now() + std::chrono::milliseconds{100}, Policy{});
+        device.join();
+    }
+
+    // median latency bucket
+    std::uint64_t seen = 0;
+    std::size_t median = 0;
+    while (median < stats::latency.size() and (seen += stats::latency[median]) * 2 < waits) {
+        ++median;
+    }
+    std::cout << "wait " << name << ": " << std::dec
+              << static_cast<double>(stats::polls) / stats::waits << " polls/wait, median latency < "
+              << (std::uint64_t{1} << median) / 1000 << " us, " << stats::timeouts << " timeouts" << std::endl;
+}
+
+void bench_polling() {
+    bench_wait<0, ros::policy::poll_spin>("spin   ");
+    bench_wait<1, ros::policy::poll_pause>("pause  ");
+    bench_wait<2, ros::policy::poll_backoff<>>("backoff");
+}
+
+void bench_concurrency() {
+    for (bool shared : {true, false}) {
+        bench_contention<ros::policy::no_lock, 0x000>("no_lock  ", shared);
+        bench_contention<ros::policy::spin_lock, 0x400>("spin_lock", shared);
+        bench_contention<ros::policy::cas, 0x800>("cas      ", shared);
+    }
+    bench_transaction_contention<ros::policy::spin_lock, 0xc00>("spin_lock");
+    bench_transaction_contention<ros::policy::cas, 0xc04>("cas      ");
+    bench_lane_contention<ros::policy::spin_lock, 0xd00>("spin_lock");
+    bench_lane_contention<ros::policy::cas, 0xd04>("cas      ");
+    bench_ring_contention();
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 and std::string_view{argv[1]} == "--codegen") {
+        bench_codegen();
+        return 0;
+    }
+    if (argc > 1 and std::string_view{argv[1]} == "--bench") {
+        bench_apply();
+        bench_recording();
+        bench_decode();
+        bench_encode();
+        bench_concurrency();
+        bench_polling();
+        return 0;
+    }
 
-int main() {
     uint32_t t = 17;
 
     // multi-field write/read syntax
@@ -1362,7 +4996,168 @@ int main() {
           r1.self.read()); // receives old value of r1 (before write)
     apply(r0.self = t,
           r1.self = 0xbeef);
+    // adjacent registers are written in one burst regardless of argument order
+    apply(r3.self = 0x3_r,
+          r1.self = 0x1_r,
+          r0.self = t,
+          r2.self = 0x2_r);
+    // status snapshot: r1..r3 are read in one burst, values keep argument order
+    auto [s3, s0, s1, s2] = apply(r3.self.read(),
+                                  r0.self.read(),
+                                  r1.self.read(),
+                                  r2.self.read());
+
+
+    // disjoint field written in the same rmw as a normal field
+    auto [dj] = apply(r5.dj_field = 0x7_f,
+                      r5.field0 = 0x1_f,
+                      r5.dj_field.read());
+
+    // partial writes of whole bits through the aliases, without a read
+    apply(gpio.led0 = 0x1_f);
+    apply(gpio.led1 = t & 1);
+    apply(gpio.mode = 0x0_f, gpio.led0 = 0x0_f);
+    ros::toggle(gpio.led0, gpio.led1);
+    // anything else is still a read-modify-write
+    apply(gpio.mode = 0x5_f);
+
+    // rmw keeps the enable bits, pending W1C bits are written back as 0 and
+    // the W0C overflow bit as 1, so no interrupt is cleared by accident
+    apply(ir.enable = 0x7f_f);
+    // same for a register invocable: only the side-effect fields it changes
+    // are written as returned, here the pending bits are left alone
+    apply(ir.self([](auto r) { return r | 0x8000; }, ir.self));
+    // only W1C bits: no read, just the write
+    apply(ack.rx = 0x1_f);
+
+    // whole byte lanes go out as narrow writes without a read
+    apply(ctl.threshold = 0x40_f);
+    apply(ctl.mode = 0x1_f, ctl.threshold = t);
+    apply(ctl.prescaler = 0x3_f);
+    // mode and id don't share a lane, that's still an rmw
+    apply(ctl.mode = 0x3_f, ctl.id = 0x1_f);
+
+    // interrupt handler: one read, acknowledge what was pending and mask it
+    // until serviced, one write
+    {
+        auto irq = ros::apply_chain(ir);
+        auto [pending, enable] = irq.apply(ir.pending.read(), ir.enable.read());
+        irq.apply(ir.pending = pending);
+        auto [masked] = irq.apply(ir.enable = enable & ~pending, ir.enable.read());
+        std::cout << "irq pending " << std::hex << pending << " enable " << masked << std::endl;
+    }
+
+    // register with more fields than hand-written reflection used to support
+    auto [b7] = apply(wr.bit0 = 0x1_f,
+                      wr.bit31 = 0x1_f,
+                      wr.bit7.read());
+    auto [b63] = apply(wr64.bit0 = 0x1_f,
+                       wr64.bit62 = 0x1_f,
+                       wr64.bit63.read());
+    std::cout << "wide registers bit7 " << +b7 << " bit63 " << +b63 << std::endl;
+
+    // register invocables on an unlocked and a spin_lock destination: both
+    // see the old values, 5 + 7 and 5 * 7, the locked one is written under
+    // its lock. atomic_bus has no bursts, the adjacent sources are read one
+    // by one
+    {
+        using plain = contended_reg<ros::policy::no_lock, 0xe00, 0>;
+        using locked = contended_reg<ros::policy::spin_lock, 0xe00, 1>;
+        atomic_bus::at(0xe00) = 5;
+        atomic_bus::at(0xe04) = 7;
+        ros::apply(plain::self([](auto p, auto l) { return p + l; }, plain::self, locked::self),
+                   locked::self([](auto p, auto l) { return p * l; }, plain::self, locked::self));
+        std::cout << "invocables plain " << std::dec << atomic_bus::at(0xe00) << " locked " << atomic_bus::at(0xe04) << std::endl;
+    }
 
+    // columnar decode of a register dump
+    std::vector<uint32_t> dump{0xfff30201, 0x100110df, 0x00000000};
+    auto [c0, c1, c2, c3] = ros::decode_batch<my_reg>(dump);
+    for (std::size_t i = 0; i < dump.size(); ++i) {
+        std::cout << "sample " << std::hex << dump[i] << ": " << c0[i] << " " << c1[i] << " " << c2[i] << " " 
+                  << static_cast<unsigned>(c3[i]) << std::endl;
+    }
+    // and back, into register images
+    auto images = ros::encode_batch<my_reg>(c0, c1, c2, c3);
+    std::cout << "images " << images[0] << " " << images[1] << " " << images[2] << std::endl;
+    // columns of different lengths: only the common part is encoded
+    c3.pop_back();
+    std::array<uint32_t, 4> buffer{};
+    const auto encoded = ros::encode_batch<my_reg>(std::span{buffer}, c0, c1, c2, c3);
+    std::cout << "encoded " << std::dec << encoded << " of " << buffer.size() << " images" << std::endl;
+
+    // poll a field without building an apply per iteration
+    auto done = ros::wait_until(r0.field0, [](auto field0) { return field0 == 1; },
+                                std::chrono::steady_clock::now() + std::chrono::milliseconds{1});
+    std::cout << "field0 " << (done ? "ready" : "timed out") << " after " << std::dec << done.polls << " polls" << std::endl;
+
+    // shadowed rmw: only the first partial write reads the bus
+    apply(r4.field0 = 0x1_f);
+    apply(r4.field1 = 0x2_f);
+    apply(r4.field2 = t);
+
+    // out-of-range value is clamped and recorded in the error ring of r4
+    apply(r4.field0 = t * 100);
+    for (auto const& e : ros::policy::error_ring<>::snapshot()) {
+        std::cout << "error on addr " << std::hex << e.address << " mask " << e.mask << " value " << e.value << std::endl;
+    }
+
+    // access by name, out-of-range values are rejected
+    debug_index.write("r4.field1", 0x42);
+    auto r4_field1 = debug_index.read("r4.field1");
+    std::cout << "r4.field1 = " << std::hex << r4_field1.value_or(0) << std::endl;
+    const bool written = debug_index.write("r4.field0", 0x1000);
+    std::cout << "r4.field0 = 0x1000 " << (written ? "written" : "rejected") << std::endl;
+
+    // per register and field access counts, reported at exit
+    uart_session(t);
+
+    // bus traffic recorded live and replayed offline
+    const auto live = trace_session<recorder>(t);
+    const auto trace = recorder::snapshot();
+    ros::replay_bus::load(trace);
+    const auto replayed = trace_session<ros::replay_bus>(t);
+    const bool same = replayed == live and ros::replay_bus::divergences == 0 and ros::replay_bus::finished();
+    // stamped with their sequence number by default
+    bool numbered = true;
+    for (std::size_t i = 0; i < trace.size(); ++i) {
+        numbered &= trace[i].timestamp == trace.front().timestamp + i;
+    }
+    std::cout << std::dec << trace.size() << " transactions recorded" << (numbered ? " in order" : " out of order")
+              << ", replay " << (same ? "matches" : "diverges") << std::endl;
+
+    // 32 peripherals brought up at once by one thread, each rmw suspends on
+    // its bus transactions instead of blocking
+    []<std::size_t... Ns>(std::index_sequence<Ns...>) {
+        auto tasks = std::make_tuple(bring_up<Ns>()...);
+        std::apply([](auto&... ts) { (ts.start(), ...); }, tasks);
+        sim_async_bus::run();
+
+        const bool ok = ((std::get<Ns>(tasks).done() and std::get<Ns>(tasks).result() == 4 + Ns) and ...);
+        std::cout << std::dec << sizeof...(Ns) << " peripherals: " << sim_async_bus::completed << " transactions in "
+                  << sim_async_bus::now.count() / 1000 << " us, "
+                  << sim_async_bus::completed * sim_async_bus::latency.count() / 1000 << " us one at a time, "
+                  << (ok ? "results ok" : "wrong results") << std::endl;
+    }(std::make_index_sequence<32>{});
+
+    // boot scripts folded into constant tables. full writes only: the table
+    // goes to the bulk writer of the bus
+    using boot = ros::sequence<r1.self = 0x1_r, r2.self = 0x2_r, r3.field0 = 0x3_f, r3.field1 = 0x4_f>;
+    static_assert(boot::table.size() == 3 and boot::table[2].value == 0x4'0003);
+    boot::run();
+    // r0.field3 is left as it is, r0 is replayed with a read
+    using reconfigure = ros::sequence<r0.field0 = 0x1_f, r0.field2 = 0x0_f, r0.field1 = 0x7_f, r1.self = 0x0_r>;
+    static_assert(reconfigure::needs_read and reconfigure::table[0].keep == 0xf000'0000);
+    reconfigure::run();
+
+    // deferred writes: each register is written once when the scope ends
+    {
+        ros::transaction<my_reg4, my_reg> tx;
+        tx.apply(r4.field0 = 0x3_f);
+        tx.apply(r0.field1 = t);
+        tx.apply(r4.field1 = t, r4.field2 = 0x5_f);
+        tx.apply(r0.field0 = 0x1_f);
+    }
 
     // rmw
     apply(r0.self([](auto old_r0) {
@@ -1376,6 +5171,18 @@ int main() {
         r0.self, r1.self)
     );
 
+    // r1 and r2 are read once, in one burst, for both lambdas
+    apply(
+        r0.self([](auto r1, auto r2) {
+            return r1 ^ r2;
+        },
+        r1.self, r2.self),
+        r3.self([](auto r2, auto r1) {
+            return r1 + r2;
+        },
+        r2.self, r1.self)
+    );
+
 
     return 0;
 }
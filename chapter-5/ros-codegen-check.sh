@@ -0,0 +1,40 @@
+#!/bin/sh
+# Zero-cost check of ros::apply. Builds rmw.cpp at -O2 and -O3, counts the
+# instructions of every ros_<pattern> function against hand_<pattern>, the
+# mask-and-shift code it should compile to, and runs rmw --codegen for the
+# timings of both. Fails if any pattern takes more instructions than its
+# hand-written version.
+# usage: ./ros-codegen-check.sh
+set -e
+
+CXX=${CXX:-g++}
+OBJDUMP=${OBJDUMP:-objdump}
+PATTERNS="ct_write rt_write rt_checked_write invocable field_read multi_reg"
+
+cd "$(dirname "$0")"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+count() {
+    $OBJDUMP -d --no-show-raw-insn --disassemble="$2" "$1" | grep -cE '^ +[0-9a-f]+:'
+}
+
+failed=0
+for opt in -O2 -O3; do
+    $CXX -std=c++20 $opt rmw.cpp -o "$dir/rmw$opt"
+    echo "$opt"
+    for p in $PATTERNS; do
+        ros=$(count "$dir/rmw$opt" "ros_$p")
+        hand=$(count "$dir/rmw$opt" "hand_$p")
+        if [ "$ros" -gt "$hand" ]; then
+            verdict="FAIL"
+            failed=1
+        else
+            verdict="ok"
+        fi
+        printf '  %-18s ros %3d  hand %3d instructions  %s\n' "$p" "$ros" "$hand" "$verdict"
+    done
+    "$dir/rmw$opt" --codegen | sed 's/^/  /'
+done
+
+exit $failed
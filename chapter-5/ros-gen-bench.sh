@@ -0,0 +1,44 @@
+#!/bin/sh
+# Compile time and object size of rmw.cpp with and without a generated
+# register map of N registers (5000 by default).
+# usage: ./ros-gen-bench.sh [registers]
+set -e
+
+N=${1:-5000}
+CXX=${CXX:-g++}
+FLAGS="-std=c++20 -O2"
+
+cd "$(dirname "$0")"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+$CXX $FLAGS ros-gen.cpp -o "$dir/ros-gen"
+
+# bits 30..0 of a 32-bit register would need an exclusive msb of 31, which
+# ros::field takes as the top bit. the generator has to emit a disjoint field
+# covering exactly those bits instead
+cat > "$dir/top.csv" <<EOF
+CTRL, 0x40000000, 32, low,  0, 31, read-write
+CTRL, 0x40000000, 32, flag, 31, 1, read-write
+EOF
+"$dir/ros-gen" --bus sim_bus "$dir/top.csv" -o "$dir/top.hpp"
+cat >> "$dir/top.hpp" <<EOF
+static_assert(decltype(regs::CTRL.low)::mask == 0x7fffffff and decltype(regs::CTRL.low)::max_value == 0x7fffffff);
+static_assert(decltype(regs::CTRL.flag)::mask == 0x80000000);
+EOF
+$CXX -std=c++20 -fsyntax-only -DROS_REGISTER_MAP="\"$dir/top.hpp\"" rmw.cpp
+echo "bits 30..0: emitted as $(grep -o 'ros::[a-z_]*field<CTRL_t' "$dir/top.hpp" | head -1 | cut -d'<' -f1)"
+"$dir/ros-gen" --bus sim_bus --synthetic "$N" -o "$dir/map.hpp"
+
+measure() {
+    name=$1
+    shift
+    start=$(date +%s%N)
+    $CXX $FLAGS "$@" -c rmw.cpp -o "$dir/$name.o"
+    end=$(date +%s%N)
+    echo "$name: $(( (end - start) / 1000000 )) ms, $(wc -c < "$dir/$name.o") bytes object"
+}
+
+echo "map: $N registers, $(wc -l < "$dir/map.hpp") lines, $(wc -c < "$dir/map.hpp") bytes"
+measure baseline
+measure with-map -DROS_REGISTER_MAP="\"$dir/map.hpp\""
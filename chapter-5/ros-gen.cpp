@@ -0,0 +1,356 @@
+// ros-gen: generates ros::reg / ros::field definitions from a register
+// description, so register maps don't have to be written by hand.
+//
+// Input is a CSV subset of SVD, one field per line:
+//
+//   # register, address, width, field, bitOffset, bitWidth, access
+//   CTRL,   0x40000000, 32, enable, 0, 1, read-write
+//   CTRL,   0x40000000, 32, mode,   1, 3, read-write
+//   STATUS, 0x40000004, 32, ready,  0, 1, read-only
+//   STATUS, 0x40000004, 32, error,  1, 1, oneToClear
+//
+// Access is an SVD access (read-only, write-only, read-write), an SVD
+// modifiedWriteValues (oneToClear, zeroToClear, oneToSet) or a ros access
+// name (RO, WO, RW, RW_1C, RW_0C, RW_1S). Bit ranges are given as offset and
+// width and translated to the msb/lsb convention of ros::field. A multi-bit
+// field ending one bit below the top has no such msb and becomes a
+// ros::disjoint_field of its lower bits and that bit.
+//
+// The output is a header with one struct per register, an inline instance
+// of each and constexpr tables of register addresses and fields sorted by
+// name, so lookups by name can be evaluated at compile time. With --index it
+// also holds a ros::register_index named "index", for O(1) runtime access by
+// "REG" or "REG.field" names. The bus type
+// (--bus) has to be declared before the header is included. Bit positions
+// and addresses are spelled out as template arguments rather than _msb,
+// _lsb and _addr literals, every distinct literal would be one more
+// instantiation of the literal parser.
+//
+// usage: ros-gen [options] <map.csv>
+//        ros-gen [options] --synthetic <registers>
+//   -o <file>           output file, stdout by default
+//   --bus <type>        bus of all registers, mmio_bus by default
+//   --namespace <name>  namespace of the generated code, regs by default
+//   --index             emit the runtime register index as well
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct field_desc {
+    std::string name;
+    unsigned offset;
+    unsigned width;
+    std::string access;
+};
+
+struct register_desc {
+    std::string name;
+    std::uint64_t address;
+    unsigned width;
+    std::vector<field_desc> fields;
+};
+
+struct options {
+    std::string input;
+    std::string output;
+    std::string bus = "mmio_bus";
+    std::string ns = "regs";
+    std::size_t synthetic = 0;
+    bool index = false;
+};
+
+std::string trim(std::string_view s) {
+    auto begin = s.find_first_not_of(" \t\r");
+    auto end = s.find_last_not_of(" \t\r");
+    return begin == std::string_view::npos ? std::string{} : std::string{s.substr(begin, end - begin + 1)};
+}
+
+bool is_identifier(std::string_view s) {
+    if (s.empty() or std::isdigit(static_cast<unsigned char>(s[0]))) {
+        return false;
+    }
+    return std::all_of(s.begin(), s.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) or c == '_';
+    });
+}
+
+std::optional<std::uint64_t> parse_number(std::string const& s) {
+    try {
+        std::size_t used = 0;
+        auto value = std::stoull(s, &used, 0);
+        if (used == s.size()) {
+            return value;
+        }
+    } catch (std::exception const&) {
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> parse_access(std::string const& s) {
+    static const std::map<std::string, std::string, std::less<>> names{
+        {"read-only", "RO"}, {"write-only", "WO"}, {"read-write", "RW"},
+        {"oneToClear", "RW_1C"}, {"zeroToClear", "RW_0C"}, {"oneToSet", "RW_1S"},
+        {"RO", "RO"}, {"WO", "WO"}, {"RW", "RW"},
+        {"RW_1C", "RW_1C"}, {"RW_0C", "RW_0C"}, {"RW_1S", "RW_1S"}
+    };
+    auto it = names.find(s);
+    return it == names.end() ? std::nullopt : std::optional{it->second};
+}
+
+// registers in order of their first appearance, fields in file order
+std::optional<std::vector<register_desc>> parse_csv(std::istream& in, std::string const& file) {
+    std::vector<register_desc> registers;
+    std::map<std::string, std::size_t> index;
+    bool ok = true;
+
+    auto error = [&](std::size_t line, std::string const& message) {
+        std::cerr << file << ":" << line << ": " << message << std::endl;
+        ok = false;
+    };
+
+    std::string text;
+    for (std::size_t line = 1; std::getline(in, text); ++line) {
+        text = trim(text);
+        if (text.empty() or text[0] == '#') {
+            continue;
+        }
+
+        std::vector<std::string> cols;
+        std::stringstream row{text};
+        for (std::string col; std::getline(row, col, ',');) {
+            cols.push_back(trim(col));
+        }
+        if (cols.size() != 7) {
+            error(line, "expected 7 columns: register, address, width, field, bitOffset, bitWidth, access");
+            continue;
+        }
+
+        auto address = parse_number(cols[1]);
+        auto width = parse_number(cols[2]);
+        auto offset = parse_number(cols[4]);
+        auto bits = parse_number(cols[5]);
+        auto access = parse_access(cols[6]);
+        if (not is_identifier(cols[0]) or not is_identifier(cols[3])) {
+            error(line, "register and field names must be C++ identifiers");
+        } else if (not address or not width or not offset or not bits) {
+            error(line, "address, width, bitOffset and bitWidth must be numbers");
+        } else if (*width != 8 and *width != 16 and *width != 32 and *width != 64) {
+            error(line, "register width must be 8, 16, 32 or 64");
+        } else if (*bits == 0 or *offset + *bits > *width) {
+            error(line, "field " + cols[3] + " doesn't fit into the register");
+        } else if (not access) {
+            error(line, "unknown access " + cols[6]);
+        } else {
+            auto [it, added] = index.try_emplace(cols[0], registers.size());
+            if (added) {
+                registers.push_back({cols[0], *address, static_cast<unsigned>(*width), {}});
+            }
+            auto& reg = registers[it->second];
+            if (reg.address != *address or reg.width != *width) {
+                error(line, "register " + reg.name + " redefined with a different address or width");
+                continue;
+            }
+            for (auto const& f : reg.fields) {
+                if (f.name == cols[3]) {
+                    error(line, "field " + f.name + " defined twice");
+                } else if (f.offset < *offset + *bits and *offset < f.offset + f.width) {
+                    error(line, "field " + cols[3] + " overlaps " + f.name);
+                }
+            }
+            reg.fields.push_back({cols[3], static_cast<unsigned>(*offset), static_cast<unsigned>(*bits), *access});
+        }
+    }
+
+    return ok ? std::optional{std::move(registers)} : std::nullopt;
+}
+
+// map of N registers with four fields each, for compile time measurements
+std::vector<register_desc> synthetic_map(std::size_t n) {
+    static const char* accesses[] = {"RW", "RW", "RO", "RW_1C"};
+    std::vector<register_desc> registers;
+    registers.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        register_desc reg{"REG" + std::to_string(i), 0x40000000 + 4 * i, 32, {}};
+        for (unsigned f = 0; f < 4; ++f) {
+            reg.fields.push_back({"field" + std::to_string(f), 8 * f, 8, accesses[(i + f) % 4]});
+        }
+        registers.push_back(std::move(reg));
+    }
+    return registers;
+}
+
+// ros::field takes an exclusive msb, except for single bits and fields
+// reaching the top bit of the register
+std::pair<unsigned, unsigned> msb_lsb(field_desc const& f, unsigned width) {
+    if (f.width == 1) {
+        return {f.offset, f.offset};
+    }
+    if (f.offset + f.width == width) {
+        return {width - 1, f.offset};
+    }
+    return {f.offset + f.width, f.offset};
+}
+
+void emit(std::ostream& out, std::vector<register_desc> const& registers, options const& opt) {
+    out << "// generated by ros-gen from " << (opt.synthetic ? "a synthetic map" : opt.input) << ", do not edit\n"
+        << "#pragma once\n\n"
+        << "namespace " << opt.ns << " {\n\n";
+
+    for (auto const& reg : registers) {
+        out << "struct " << reg.name << "_t : ros::reg<" << reg.name << "_t, uint" << reg.width
+            << "_t, ros::detail::addr<std::size_t, 0x" << std::hex << reg.address << std::dec << ">{}, "
+            << opt.bus << "> {\n";
+        for (auto const& f : reg.fields) {
+            if (f.width > 1 and f.offset + f.width == reg.width - 1) {
+                // ending at bit width - 2 needs an exclusive msb of width - 1,
+                // which ros::field takes as the top bit. the field is split
+                // into its lower bits and bit width - 2 instead
+                out << "    ros::disjoint_field<" << reg.name << "_t, ros::access_type::" << f.access
+                    << ", ros::field_segment<ros::detail::msb<unsigned, " << reg.width - 2
+                    << ">{}, ros::detail::lsb<unsigned, " << f.offset
+                    << ">{}>, ros::field_segment<ros::detail::msb<unsigned, " << reg.width - 2
+                    << ">{}, ros::detail::lsb<unsigned, " << reg.width - 2 << ">{}>> " << f.name << ";\n";
+                continue;
+            }
+            auto [msb, lsb] = msb_lsb(f, reg.width);
+            out << "    ros::field<" << reg.name << "_t, ros::detail::msb<unsigned, " << msb
+                << ">{}, ros::detail::lsb<unsigned, " << lsb << ">{}, ros::access_type::" << f.access << "> "
+                << f.name << ";\n";
+        }
+        out << "};\ninline " << reg.name << "_t " << reg.name << ";\n\n";
+    }
+
+    std::vector<register_desc const*> by_name;
+    for (auto const& reg : registers) by_name.push_back(&reg);
+    std::sort(by_name.begin(), by_name.end(), [](auto a, auto b) { return a->name < b->name; });
+
+    out << "struct register_info {\n"
+        << "    std::string_view name;\n"
+        << "    std::size_t address;\n"
+        << "    unsigned width;\n"
+        << "};\n\n"
+        << "struct field_info {\n"
+        << "    std::string_view reg;\n"
+        << "    std::string_view name;\n"
+        << "    unsigned lsb;\n"
+        << "    unsigned width;\n"
+        << "    ros::access_type access;\n"
+        << "};\n\n";
+
+    out << "// sorted by name\n"
+        << "inline constexpr std::array<register_info, " << by_name.size() << "> registers{{\n";
+    for (auto reg : by_name) {
+        out << "    {\"" << reg->name << "\", 0x" << std::hex << reg->address << std::dec << ", " << reg->width << "},\n";
+    }
+    out << "}};\n\n";
+
+    std::vector<std::pair<register_desc const*, field_desc const*>> fields;
+    for (auto reg : by_name) {
+        std::vector<field_desc const*> own;
+        for (auto const& f : reg->fields) own.push_back(&f);
+        std::sort(own.begin(), own.end(), [](auto a, auto b) { return a->name < b->name; });
+        for (auto f : own) fields.emplace_back(reg, f);
+    }
+
+    out << "// sorted by register and field name\n"
+        << "inline constexpr std::array<field_info, " << fields.size() << "> fields{{\n";
+    for (auto [reg, f] : fields) {
+        out << "    {\"" << reg->name << "\", \"" << f->name << "\", " << f->offset << ", " << f->width
+            << ", ros::access_type::" << f->access << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "constexpr auto find_register(std::string_view name) -> register_info const* {\n"
+        << "    auto it = std::lower_bound(registers.begin(), registers.end(), name,\n"
+        << "                               [](auto const& r, std::string_view n) { return r.name < n; });\n"
+        << "    return it != registers.end() and it->name == name ? &*it : nullptr;\n"
+        << "}\n\n"
+        << "constexpr auto find_field(std::string_view reg, std::string_view name) -> field_info const* {\n"
+        << "    auto it = std::lower_bound(fields.begin(), fields.end(), std::pair{reg, name},\n"
+        << "                               [](auto const& f, auto const& key) {\n"
+        << "                                   return std::pair{f.reg, f.name} < key;\n"
+        << "                               });\n"
+        << "    return it != fields.end() and it->reg == reg and it->name == name ? &*it : nullptr;\n"
+        << "}\n";
+
+    if (opt.index) {
+        out << "\ninline constexpr ros::register_index index{std::array{\n";
+        for (std::size_t i = 0; i < registers.size(); ++i) {
+            auto const& reg = registers[i];
+            out << "    ros::indexed<" << reg.name << "_t>(\"" << reg.name << "\")";
+            for (auto const& f : reg.fields) {
+                out << ",\n    ros::indexed<decltype(" << reg.name << "_t::" << f.name << ")>(\""
+                    << reg.name << "." << f.name << "\")";
+            }
+            out << (i + 1 < registers.size() ? ",\n" : "\n");
+        }
+        out << "}};\n";
+    }
+    out << "} // namespace " << opt.ns << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "-o" and has_value) {
+            opt.output = argv[++i];
+        } else if (arg == "--bus" and has_value) {
+            opt.bus = argv[++i];
+        } else if (arg == "--namespace" and has_value) {
+            opt.ns = argv[++i];
+        } else if (arg == "--index") {
+            opt.index = true;
+        } else if (arg == "--synthetic" and has_value) {
+            opt.synthetic = parse_number(argv[++i]).value_or(0);
+        } else if (not arg.starts_with("-") and opt.input.empty()) {
+            opt.input = arg;
+        } else {
+            opt.input.clear();
+            opt.synthetic = 0;
+            break;
+        }
+    }
+    if (opt.input.empty() == (opt.synthetic == 0)) {
+        std::cerr << "usage: ros-gen [-o file] [--bus type] [--namespace name] [--index] (<map.csv> | --synthetic <registers>)" << std::endl;
+        return 2;
+    }
+
+    std::vector<register_desc> registers;
+    if (opt.synthetic) {
+        registers = synthetic_map(opt.synthetic);
+    } else {
+        std::ifstream in{opt.input};
+        if (not in) {
+            std::cerr << "cannot open " << opt.input << std::endl;
+            return 1;
+        }
+        auto parsed = parse_csv(in, opt.input);
+        if (not parsed) {
+            return 1;
+        }
+        registers = std::move(*parsed);
+    }
+
+    if (opt.output.empty()) {
+        emit(std::cout, registers, opt);
+    } else {
+        std::ofstream out{opt.output};
+        emit(out, registers, opt);
+        if (not out) {
+            std::cerr << "cannot write " << opt.output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+# Compile time of registers with N single-bit fields and one apply on each,
+# the cost of the reflection path (field count, to_tuple, layout masks).
+# REGS such registers are compiled with -fsyntax-only, best of three, minus
+# rmw.cpp alone, and the difference is divided by REGS.
+# usage: [REGS=20] ./ros-reflect-bench.sh [fields...]    (16 32 64 by default)
+set -e
+
+CXX=${CXX:-g++}
+FLAGS="-std=c++20 -fsyntax-only"
+REGS=${REGS:-20}
+[ $# -gt 0 ] || set -- 16 32 64
+
+cd "$(dirname "$0")"
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+# best of three, in ms
+compile() {
+    best=
+    for run in 1 2 3; do
+        start=$(date +%s%N)
+        $CXX $FLAGS "$@" rmw.cpp
+        end=$(date +%s%N)
+        ms=$(( (end - start) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then
+            best=$ms
+        fi
+    done
+    echo "$best"
+}
+
+# REGS registers of $1 fields, each with an apply writing two fields and
+# reading a third
+generate() {
+    n=$1
+    r=0
+    while [ $r -lt "$REGS" ]; do
+        reg="bench${n}_$r"
+        echo "struct ${reg}_t : ros::reg<${reg}_t, uint64_t, ros::detail::addr<std::size_t, $((0x90000000 + 8 * r))>{}, sim_bus> {"
+        i=0
+        while [ $i -lt "$n" ]; do
+            echo "    ros::field<${reg}_t, ${i}_msb, ${i}_lsb, ros::access_type::RW> bit$i;"
+            i=$((i + 1))
+        done
+        echo "};"
+        echo "static_assert(std::tuple_size_v<decltype(ros::reflect::to_tuple(${reg}_t{}))> == $n);"
+        echo "inline void ${reg}_apply() {"
+        echo "    ${reg}_t r;"
+        echo "    ros::apply(r.bit0 = 0x1_f, r.bit$((n - 1)) = 0x1_f, r.bit$((n / 2)).read());"
+        echo "}"
+        r=$((r + 1))
+    done
+}
+
+baseline=$(compile)
+echo "baseline: $baseline ms"
+
+for n in "$@"; do
+    if [ "$n" -lt 2 ] || [ "$n" -gt 64 ]; then
+        echo "$n fields: reflect::to_tuple supports up to 64, the apply needs 2" >&2
+        exit 1
+    fi
+    generate "$n" > "$dir/wide$n.hpp"
+    ms=$(compile -DROS_REGISTER_MAP="\"$dir/wide$n.hpp\"")
+    echo "$n fields: $ms ms for $REGS registers, $(( (ms - baseline) / REGS )) ms per register"
+done